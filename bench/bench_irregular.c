@@ -0,0 +1,240 @@
+/**
+ * Irregular Form Benchmark
+ * Time the perfect hash lookup against the original strcmp chains
+ *
+ * Usage: bench_irregular [word count] [rounds]
+ *
+ * The -ed and -ing forms of irregular and invariant verbs used to be
+ * found by comparing each word with every listed verb in turn. The same
+ * lookup now hashes the word into the generated table and compares it
+ * with one entry. Both are run over a synthetic dictionary of syllable
+ * words mixed with every verb of the old chains. Every word must get the
+ * same forms from both; the program exits non-zero otherwise.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/english_words.h"
+#include "../include/irregular_forms.h"
+#include "irregular_forms_table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_WORD_COUNT 100000
+#define DEFAULT_ROUNDS 20
+#define MAX_SYLLABLES 3
+#define GENERATOR_SEED 12345u
+
+static const char *const g_syllables[] = {
+    "a",  "an", "ar", "ba", "be", "bi", "bo", "ca", "ce", "co", "cut",
+    "da", "de", "di", "do", "e",  "en", "er", "fa", "fi", "ga", "go",
+    "i",  "in", "la", "le", "li", "lo", "ma", "me", "mi", "mo", "na",
+    "ne", "no", "o",  "on", "or", "pa", "pe", "pi", "ra", "re", "ri",
+    "ro", "sa", "se", "si", "so", "ta", "te", "ti", "to", "tu", "u"};
+
+#define SYLLABLE_COUNT (sizeof(g_syllables) / sizeof(g_syllables[0]))
+
+/* Every verb of the original chains */
+static const char *const g_chain_verbs[] = {
+    "be",    "lie",   "die",  "have",  "go",   "do",   "see",  "make",
+    "take",  "find",  "think", "teach", "grow", "drive", "wake", "read",
+    "cut",   "put",   "let",  "hit",   "quit", "shut"};
+
+#define CHAIN_VERB_COUNT (sizeof(g_chain_verbs) / sizeof(g_chain_verbs[0]))
+
+/* Timing */
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Word generation */
+
+static unsigned int next_random(unsigned int *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+/* Fill words with count words of one to three syllables, one in every
+ * hundred being a verb of the old chains */
+static char (*generate_words(int count))[MAX_WORD_LENGTH] {
+  char(*words)[MAX_WORD_LENGTH] = malloc((size_t)count * MAX_WORD_LENGTH);
+  if (words == NULL) {
+    return NULL;
+  }
+
+  unsigned int state = GENERATOR_SEED;
+  for (int i = 0; i < count; i++) {
+    if (i % 100 == 0) {
+      strcpy(words[i], g_chain_verbs[(i / 100) % CHAIN_VERB_COUNT]);
+      continue;
+    }
+
+    size_t length = 0;
+    int syllables = 1 + (int)(next_random(&state) % MAX_SYLLABLES);
+    for (int s = 0; s < syllables; s++) {
+      const char *syllable = g_syllables[next_random(&state) % SYLLABLE_COUNT];
+      memcpy(words[i] + length, syllable, strlen(syllable));
+      length += strlen(syllable);
+    }
+    words[i][length] = '\0';
+  }
+  return words;
+}
+
+/* Original lookup */
+
+/* The irregular -ed form, as the chain in generate_ed_form_into had it */
+static const char *chain_ed_form(const char *verb) {
+  if (strcmp(verb, "be") == 0) {
+    return "been";
+  }
+  if (strcmp(verb, "have") == 0) {
+    return "had";
+  }
+  if (strcmp(verb, "go") == 0) {
+    return "gone";
+  }
+  if (strcmp(verb, "do") == 0) {
+    return "done";
+  }
+  if (strcmp(verb, "see") == 0) {
+    return "seen";
+  }
+  if (strcmp(verb, "make") == 0) {
+    return "made";
+  }
+  if (strcmp(verb, "take") == 0) {
+    return "took";
+  }
+  if (strcmp(verb, "find") == 0) {
+    return "found";
+  }
+  if (strcmp(verb, "think") == 0) {
+    return "thought";
+  }
+  if (strcmp(verb, "teach") == 0) {
+    return "taught";
+  }
+  if (strcmp(verb, "grow") == 0) {
+    return "grown";
+  }
+  if (strcmp(verb, "drive") == 0) {
+    return "drove";
+  }
+  if (strcmp(verb, "wake") == 0) {
+    return "woke";
+  }
+
+  /* Verbs that don't change */
+  if (strcmp(verb, "read") == 0 || strcmp(verb, "cut") == 0 ||
+      strcmp(verb, "put") == 0 || strcmp(verb, "let") == 0 ||
+      strcmp(verb, "hit") == 0 || strcmp(verb, "quit") == 0 ||
+      strcmp(verb, "shut") == 0) {
+    return verb;
+  }
+  return NULL;
+}
+
+/* The irregular -ing form, as the chain in generate_ing_form_into had it */
+static const char *chain_ing_form(const char *verb) {
+  if (strcmp(verb, "be") == 0) {
+    return "being";
+  }
+  if (strcmp(verb, "lie") == 0) {
+    return "lying";
+  }
+  if (strcmp(verb, "die") == 0) {
+    return "dying";
+  }
+  return NULL;
+}
+
+/* Current lookup */
+
+/* Same lookup as find_irregular_form in inflections.c */
+static const char *table_form(const char *word, Inflection inflection) {
+  uint64_t hash = hash_irregular_word(word, IRREGULAR_WORD_SEED);
+  uint32_t bucket = irregular_word_bucket(hash, IRREGULAR_WORD_BUCKETS);
+  const IrregularWord *entry =
+      &g_irregular_words[irregular_word_slot(
+          hash, g_irregular_word_displacements[bucket], IRREGULAR_WORD_SLOTS)];
+
+  if (entry->word == NULL || strcmp(entry->word, word) != 0) {
+    return NULL;
+  }
+  return entry->forms[inflection];
+}
+
+static bool same_form(const char *a, const char *b) {
+  return a == b || (a != NULL && b != NULL && strcmp(a, b) == 0);
+}
+
+int main(int argc, char *argv[]) {
+  int word_count = argc > 1 ? atoi(argv[1]) : DEFAULT_WORD_COUNT;
+  int rounds = argc > 2 ? atoi(argv[2]) : DEFAULT_ROUNDS;
+  if (word_count <= 0 || rounds <= 0) {
+    fprintf(stderr, "Usage: %s [word count] [rounds]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  char(*words)[MAX_WORD_LENGTH] = generate_words(word_count);
+  if (words == NULL) {
+    fprintf(stderr, "Out of memory\n");
+    return EXIT_FAILURE;
+  }
+  printf("Irregular -ed/-ing lookups, %d words x %d rounds\n", word_count,
+         rounds);
+
+  /* Count the hits so that neither loop can be optimised away */
+  long lookups = 2L * word_count * rounds;
+  long chain_hits = 0;
+  double start = now_seconds();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < word_count; i++) {
+      chain_hits += chain_ed_form(words[i]) != NULL;
+      chain_hits += chain_ing_form(words[i]) != NULL;
+    }
+  }
+  double chain = now_seconds() - start;
+
+  long table_hits = 0;
+  start = now_seconds();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < word_count; i++) {
+      table_hits += table_form(words[i], INFLECTION_ED) != NULL;
+      table_hits += table_form(words[i], INFLECTION_ING) != NULL;
+    }
+  }
+  double table = now_seconds() - start;
+
+  int mismatches = 0;
+  for (int i = 0; i < word_count; i++) {
+    const char *ed = table_form(words[i], INFLECTION_ED);
+    const char *ing = table_form(words[i], INFLECTION_ING);
+    if (!same_form(chain_ed_form(words[i]), ed) ||
+        !same_form(chain_ing_form(words[i]), ing)) {
+      mismatches++;
+      fprintf(stderr, "Mismatch for %s: chain %s/%s, table %s/%s\n", words[i],
+              chain_ed_form(words[i]) ? chain_ed_form(words[i]) : "none",
+              chain_ing_form(words[i]) ? chain_ing_form(words[i]) : "none",
+              ed ? ed : "none", ing ? ing : "none");
+    }
+  }
+
+  printf("  strcmp chains: %8.1f ns/lookup (%ld hits)\n",
+         chain * 1e9 / (double)lookups, chain_hits);
+  printf("  perfect hash:  %8.1f ns/lookup (%ld hits)\n",
+         table * 1e9 / (double)lookups, table_hits);
+  printf("  speedup:       %8.1fx\n", table > 0 ? chain / table : 0.0);
+  printf("  mismatches:    %8d\n", mismatches);
+
+  free(words);
+  return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,163 @@
+/**
+ * Subword Link Benchmark
+ * Time the length-partitioned subword search against the original scan
+ *
+ * Usage: bench_subwords [word count] [sample size]
+ *
+ * A synthetic dictionary of syllable words is loaded and linked with
+ * create_subword_links. The original search compared every word with
+ * every other word, which takes minutes at this size, so it is run for an
+ * evenly spaced sample of words and its time scaled to the whole
+ * dictionary. Every sampled word must get the same shortest superword
+ * from both searches; the program exits non-zero otherwise.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/english_words.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_WORD_COUNT 100000
+#define DEFAULT_SAMPLE_SIZE 500
+#define MAX_SYLLABLES 4
+#define GENERATOR_SEED 12345u
+
+static const char *const g_syllables[] = {
+    "a",   "an",  "ar",  "ba",  "be",  "bi",  "bo",  "ca",  "ce",  "co",
+    "da",  "de",  "di",  "do",  "e",   "en",  "er",  "fa",  "fi",  "ga",
+    "i",   "in",  "la",  "le",  "li",  "lo",  "ma",  "me",  "mi",  "mo",
+    "na",  "ne",  "no",  "o",   "on",  "or",  "pa",  "pe",  "pi",  "ra",
+    "re",  "ri",  "ro",  "sa",  "se",  "si",  "so",  "ta",  "te",  "ti",
+    "to",  "tra", "tu",  "u",   "un",  "va",  "ve",  "vi",  "ing", "ed",
+    "est", "art", "st",  "str", "tion"};
+
+#define SYLLABLE_COUNT (sizeof(g_syllables) / sizeof(g_syllables[0]))
+
+/* Timing */
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Dictionary generation */
+
+static unsigned int next_random(unsigned int *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+/* Insert count distinct words of one to four syllables */
+static int generate_words(int count) {
+  unsigned int state = GENERATOR_SEED;
+  int inserted = 0;
+  long attempts = 0;
+
+  while (inserted < count && attempts < 100L * count) {
+    char word[MAX_WORD_LENGTH];
+    size_t length = 0;
+    int syllables = 1 + (int)(next_random(&state) % MAX_SYLLABLES);
+
+    for (int s = 0; s < syllables; s++) {
+      const char *syllable = g_syllables[next_random(&state) % SYLLABLE_COUNT];
+      if (s > 0) {
+        word[length++] = '/';
+      }
+      memcpy(word + length, syllable, strlen(syllable));
+      length += strlen(syllable);
+    }
+    word[length] = '\0';
+    attempts++;
+
+    int index = get_word_letter_index(word);
+    if (index >= 0 &&
+        insert_word_sorted_by_length(&g_word_lists[index], word) == SUCCESS) {
+      inserted++;
+    }
+  }
+  return inserted;
+}
+
+/* Original search */
+
+/* Scan of every word, in list order, keeping the first shortest match */
+static const WordNode *scan_subword_of(const WordNode *node) {
+  const WordNode *best = NULL;
+
+  for (int i = 0; i < ALPHABET_SIZE; i++) {
+    const LetterList *list = &g_word_lists[i];
+
+    for (int pos = 0; pos < list->count; pos++) {
+      const WordNode *candidate = word_node_at(list->ids[pos]);
+      if (candidate != node &&
+          is_subword(node->clean_word, candidate->clean_word) &&
+          (best == NULL || candidate->char_count < best->char_count)) {
+        best = candidate;
+      }
+    }
+  }
+  return best;
+}
+
+int main(int argc, char *argv[]) {
+  int word_count = argc > 1 ? atoi(argv[1]) : DEFAULT_WORD_COUNT;
+  int sample_size = argc > 2 ? atoi(argv[2]) : DEFAULT_SAMPLE_SIZE;
+  if (word_count <= 0 || sample_size <= 0) {
+    fprintf(stderr, "Usage: %s [word count] [sample size]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  int loaded = generate_words(word_count);
+  printf("Subword links, %d words\n", loaded);
+
+  double start = now_seconds();
+  int links = create_subword_links();
+  double partitioned = now_seconds() - start;
+  printf("  length-partitioned search: %8.3f s (%d links)\n", partitioned,
+         links);
+
+  /* Every step-th word in list order */
+  int step = loaded / sample_size > 0 ? loaded / sample_size : 1;
+  int sampled = 0;
+  int mismatches = 0;
+  int seen = 0;
+
+  start = now_seconds();
+  for (int i = 0; i < ALPHABET_SIZE; i++) {
+    const LetterList *list = &g_word_lists[i];
+
+    for (int pos = 0; pos < list->count; pos++, seen++) {
+      if (seen % step != 0 || sampled == sample_size) {
+        continue;
+      }
+
+      const WordNode *node = word_node_at(list->ids[pos]);
+      const WordNode *expected = scan_subword_of(node);
+      const WordNode *actual = linked_word(node, RELATION_SUBWORD);
+      sampled++;
+
+      if (expected != actual) {
+        mismatches++;
+        fprintf(stderr, "Mismatch for %s: scan %s, partitioned %s\n",
+                node->clean_word, expected ? expected->clean_word : "none",
+                actual ? actual->clean_word : "none");
+      }
+    }
+  }
+  double scan = (now_seconds() - start) * loaded / (sampled > 0 ? sampled : 1);
+
+  printf("  full scan (from %d words): %8.3f s\n", sampled, scan);
+  printf("  speedup:                   %8.1fx\n",
+         partitioned > 0 ? scan / partitioned : 0.0);
+  printf("  mismatches:                %8d\n", mismatches);
+
+  cleanup_word_lists();
+  stop_thread_pool();
+  return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -12,14 +12,25 @@
 #define ENGLISH_WORDS_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /* Constants */
-#define MAX_WORDS 1000
 #define MAX_WORD_LENGTH 50
-#define MAX_SYLLABLE_LENGTH 10
 #define ALPHABET_SIZE 26
 #define MAX_FILENAME_LENGTH 100
 #define INVALID_LIST_INDEX 26
+#define HISTOGRAM_BINS MAX_WORD_LENGTH
+#define INFLECTION_BUFFER_SIZE (MAX_WORD_LENGTH + 8) /* Any inflected form */
+#define CHAR_CLASS_WINDOW 64 /* Characters classified in one call */
+#define ARENA_SIZE_CLASSES 128 /* Arena free lists, for blocks up to 1 KiB */
+#define NO_NODE_ID 0xFFFFFFFFu /* Link id meaning "no word" */
+
+/* Packed words: 5 bits per letter, 12 letters per 64-bit lane */
+#define PACKED_LETTER_BITS 5
+#define PACKED_LETTERS_PER_LANE 12
+#define PACKED_WORD_LANES 2
+#define PACKED_WORD_MAX_LETTERS (PACKED_LETTERS_PER_LANE * PACKED_WORD_LANES)
 
 /* Error codes */
 typedef enum {
@@ -31,63 +42,240 @@ typedef enum {
   ERROR_WORD_NOT_FOUND = -5
 } ErrorCode;
 
+/* Inflected forms generated from a word */
+typedef enum {
+  INFLECTION_ED = 0, /* Past or participle */
+  INFLECTION_ING,    /* Gerund */
+  INFLECTION_S,      /* Third person singular, or plural */
+  INFLECTION_ER,     /* -er, comparative of adjectives */
+  INFLECTION_EST,    /* -est, superlative of adjectives */
+  INFLECTION_COUNT
+} Inflection;
+
+/* Kinds of links between words */
+typedef enum {
+  RELATION_SUBWORD = 0,
+  RELATION_ED_FORM, /* Inflection links, in Inflection order */
+  RELATION_ING_FORM,
+  RELATION_S_FORM,
+  RELATION_ER_FORM,
+  RELATION_EST_FORM,
+  RELATION_ADD_ONE_CHAR,
+  RELATION_LEXICALLY_CLOSE,
+  RELATION_ANAGRAM,
+  RELATION_COUNT
+} RelationKind;
+
+/* Link kind holding an inflected form */
+static inline RelationKind inflection_relation(Inflection inflection) {
+  return (RelationKind)(RELATION_ED_FORM + (int)inflection);
+}
+
+/* Per-word counts mirrored into dense columns */
+typedef enum {
+  COLUMN_CHARACTERS = 0,
+  COLUMN_CONSONANTS,
+  COLUMN_VOWELS,
+  COLUMN_SYLLABLES,
+  COLUMN_ORDERED,
+  COLUMN_COUNT
+} WordColumn;
+
+/* Comparison applied to a column by a query condition */
+typedef enum {
+  QUERY_EQUAL = 0,
+  QUERY_NOT_EQUAL,
+  QUERY_LESS,
+  QUERY_LESS_EQUAL,
+  QUERY_GREATER,
+  QUERY_GREATER_EQUAL
+} QueryOperator;
+
+/* Edit journal record types (the leading character of each record) */
+typedef enum { JOURNAL_INSERT = '+', JOURNAL_DELETE = '-' } JournalOperation;
+
 /* Forward declarations */
-typedef struct Syllable Syllable;
+typedef struct ArenaChunk ArenaChunk;
+typedef struct FreeBlock FreeBlock;
 typedef struct WordNode WordNode;
 typedef struct LetterList LetterList;
+typedef struct WordBucket WordBucket;
 
-/* Syllable structure for syllable lists */
-struct Syllable {
-  char text[MAX_SYLLABLE_LENGTH];
-  Syllable *next;
-};
+/* Reverse edge: a link of the given kind from source to this word */
+typedef struct {
+  unsigned int source; /* Node id of the linking word */
+  RelationKind kind;
+} Backlink;
+
+/* Case-folded letter codes plus per-letter case; all zero if not packed */
+typedef struct {
+  uint64_t lanes[PACKED_WORD_LANES]; /* a = 1 ... z = 26, 0 past the end */
+  uint64_t case_bits;                /* Bit i set if letter i is upper case */
+} PackedWord;
 
 /* Word node structure containing word data and relationships */
 struct WordNode {
-  char *original_word;            /* Word as read from file (with slashes) */
   char *clean_word;               /* Word without slashes */
-  int char_count;                 /* Number of characters */
-  int consonant_count;            /* Number of consonants */
-  int vowel_count;                /* Number of vowels */
-  int syllable_count;             /* Number of syllables */
-  Syllable *syllables;            /* List of syllables */
+  uint64_t syllable_breaks;       /* Bit i set if a syllable starts at i > 0 */
+  unsigned char char_count;       /* Number of characters */
+  unsigned char consonant_count;  /* Number of consonants */
+  unsigned char vowel_count;      /* Number of vowels */
   bool is_alphabetically_ordered; /* Characters in alphabetical order */
-  char *alphabetically_sorted;    /* Word with sorted characters */
-
-  WordNode *next; /* Next word in list */
-  WordNode *prev; /* Previous word in list */
-
-  /* Word relationships */
-  WordNode *subword_of;      /* Larger word containing this word */
-  WordNode *ed_form;         /* Past participle form */
-  WordNode *ing_form;        /* Gerund form */
-  WordNode *add_one_char;    /* Word with one additional character */
-  WordNode *lexically_close; /* Lexically similar word */
-  WordNode *anagram;         /* Anagram of this word */
+  unsigned int letter_mask;       /* Bit i set if letter 'a' + i occurs */
+  unsigned char letter_counts[ALPHABET_SIZE]; /* Occurrences per letter */
+  unsigned short valid_links;     /* Deferred links computed for this word */
+  unsigned int hash;              /* Hash of clean_word (word index key) */
+  PackedWord packed;              /* clean_word packed, if short enough */
+  unsigned long sequence;         /* Insertion order, breaks length ties */
+  unsigned int id;                /* Slot in the node table */
+
+  /*
+   * Word relationships, indexed by RelationKind: the node id of the
+   * superword, inflected forms, word with one character added,
+   * lexically close word and next anagram, or NO_NODE_ID
+   */
+  unsigned int links[RELATION_COUNT];
+  WordBucket *anagram_class; /* All words sharing this signature */
+
+  /* Links from other words pointing at this one */
+  Backlink *backlinks;
+  int backlink_count;
+  int backlink_capacity;
 };
 
+/* Bucket of words sharing a key (anagram class, ...) */
+struct WordBucket {
+  char *key;             /* Shared key, NULL in a packed bucket */
+  PackedWord packed_key; /* Shared key of a packed bucket */
+  unsigned int hash;     /* Hash of key */
+  WordNode **nodes;      /* Members, in the order they were added */
+  int count;             /* Number of members */
+  int capacity;          /* Allocated member slots */
+};
+
+/* Chunked allocator with per-size free lists; all zero when empty */
+typedef struct {
+  ArenaChunk *chunks;                         /* Newest chunk first */
+  FreeBlock *free_lists[ARENA_SIZE_CLASSES]; /* Released blocks per size */
+  size_t bytes_reserved;
+  size_t bytes_used;
+  size_t bytes_free;
+} Arena;
+
+/* Hash table of buckets keyed by string */
+typedef struct {
+  WordBucket **slots;
+  size_t capacity;
+  size_t count;
+  Arena storage; /* Buckets, their keys and member arrays */
+} BucketTable;
+
 /* Letter list structure (one per alphabet letter) */
 struct LetterList {
-  WordNode *head;
+  unsigned int *ids; /* Node ids sorted by length, then insertion order */
+  int count;         /* Number of words */
+  int capacity;      /* Allocated id slots */
+  int length_start[MAX_WORD_LENGTH + 1]; /* First position per word length */
 };
 
 /* Global word lists array (A-Z plus one for invalid words) */
 extern LetterList g_word_lists[ALPHABET_SIZE + 1];
 
+/* Node table mapping ids stored in the letter lists to their nodes */
+extern WordNode **g_node_table;
+
+static inline WordNode *word_node_at(unsigned int id) {
+  return g_node_table[id];
+}
+
+/* Word that node links to by kind, or NULL */
+static inline WordNode *linked_word(const WordNode *node, RelationKind kind) {
+  unsigned int id = node->links[kind];
+  return id != NO_NODE_ID ? g_node_table[id] : NULL;
+}
+
+/* Character classes of a short string, bit i describing character i */
+typedef struct {
+  uint64_t letters; /* ASCII letters */
+  uint64_t vowels;  /* a, e, i, o, u and y in either case */
+  uint64_t slashes; /* Syllable separators */
+} CharClasses;
+
+/* Derived fields of one word, computed without touching the dictionary */
+typedef struct {
+  char clean_word[MAX_WORD_LENGTH];
+  int char_count;
+  int consonant_count;
+  int vowel_count;
+  int syllable_count;
+  bool is_alphabetically_ordered;
+  unsigned int letter_mask;
+  unsigned char letter_counts[ALPHABET_SIZE];
+  uint64_t syllable_breaks; /* Bit i set if a syllable starts at i > 0 */
+} WordAnalysis;
+
 /* Statistics structure */
 typedef struct {
   int word_count;
   int subword_links;
   int verb_form_links;
+  int inflection_links; /* -s, -er and -est forms */
+  int add_one_char_links;
   int lexclose_links;
   int anagram_links;
 } Statistics;
 
+/* Outcome of a batch insert or delete */
+typedef struct {
+  int applied;    /* Words inserted or deleted */
+  int duplicates; /* Already present, or repeated within the batch */
+  int missing;    /* Words to delete that are not in the dictionary */
+  int invalid;    /* Words rejected by validation */
+  bool saved;     /* Whether the edits reached the journal */
+} BatchResult;
+
+/* Body of a parallel loop, run over iterations [begin, end) */
+typedef void (*ParallelBody)(void *context, size_t begin, size_t end);
+
+/* Loop handed to the thread pool, run in chunks of grain iterations */
+typedef struct {
+  ParallelBody body;
+  void *context;
+  size_t count; /* Iterations */
+  size_t grain; /* Iterations per chunk */
+} ParallelLoop;
+
+/* One term of a word query, e.g. syllables=3 */
+typedef struct {
+  WordColumn column;
+  QueryOperator op;
+  unsigned char value;
+} QueryCondition;
+
+/* Word arena statistics */
+typedef struct {
+  size_t bytes_reserved; /* Chunk memory obtained from the system */
+  size_t bytes_used;     /* Bytes held by live allocations */
+  size_t bytes_free;     /* Released or stranded bytes awaiting reuse */
+} ArenaStatistics;
+
+/* Arenas */
+void *arena_alloc_in(Arena *arena, size_t size);
+void arena_free_in(Arena *arena, void *ptr, size_t size);
+void arena_release(Arena *arena);
+
+/* Word arena */
+void *arena_alloc(size_t size);
+char *arena_copy_string(const char *text);
+void arena_free(void *ptr, size_t size);
+size_t arena_block_size(size_t size);
+void arena_release_all(void);
+void get_arena_statistics(ArenaStatistics *stats);
+
 /* Memory management */
 WordNode *allocate_word_node(void);
-Syllable *allocate_syllable(void);
 void free_word_node(WordNode *node);
-void free_syllable(Syllable *syll);
+void reset_word_lists(void);
 void cleanup_word_lists(void);
 
 /* Character operations */
@@ -95,6 +283,12 @@ bool is_vowel(char c);
 bool is_consonant(char c);
 int get_ascii_code(char c);
 
+/* Character classification (SIMD kernels picked at runtime) */
+void classify_characters(const char *text, size_t length,
+                         CharClasses *classes);
+int count_bits(uint64_t bits);
+int lowest_bit(uint64_t bits);
+
 /* Word analysis */
 int count_vowels(const char *word);
 int count_consonants(const char *word);
@@ -102,46 +296,169 @@ int count_characters(const char *word);
 int count_syllables(const char *word);
 bool is_word_alphabetically_ordered(const char *word);
 char *sort_word_alphabetically(const char *word);
+bool sort_word_alphabetically_into(const char *word, char *sorted,
+                                   size_t size);
 char *remove_slashes(const char *word);
+bool remove_slashes_into(const char *word, char *clean, size_t size);
+unsigned int compute_letter_mask(const char *word);
+void count_letters(const char *word, unsigned char counts[ALPHABET_SIZE]);
 int get_word_letter_index(const char *word);
 bool is_valid_word_format(const char *word);
-
-/* Syllable operations */
-Syllable *parse_syllables(const char *word);
-void print_syllable_list(const Syllable *syllables);
+bool is_valid_word_classes(const CharClasses *classes, size_t length);
+bool analyze_word(const char *word, WordAnalysis *analysis);
+void sort_letters(const char *word, const unsigned char counts[ALPHABET_SIZE],
+                  char *sorted);
 
 /* Word node operations */
-void initialize_word_node(WordNode *node);
 void print_word_details(const WordNode *node);
 
+/* Views derived from the clean word and its syllable breaks */
+int get_syllable_count(const WordNode *node);
+size_t get_original_length(const WordNode *node);
+size_t format_original_word(const WordNode *node, char *buffer);
+void format_sorted_word(const WordNode *node, char *buffer);
+void print_syllables(const WordNode *node);
+
 /* List operations */
-ErrorCode insert_word_sorted_by_length(WordNode **head, const char *word);
-bool delete_word_from_list(WordNode **head, const char *word);
-WordNode *search_word(const WordNode *head, const char *word);
-void print_word_list(const WordNode *head);
+ErrorCode insert_word_sorted_by_length(LetterList *list, const char *word);
+ErrorCode insert_word_span(LetterList *list, const char *word, size_t length);
+ErrorCode insert_analyzed_word(LetterList *list, const WordAnalysis *analysis);
+ErrorCode append_word_node(LetterList *list, WordNode *node);
+bool delete_word_from_list(LetterList *list, const char *word);
+WordNode *search_word(const char *word);
+int compare_word_order(const WordNode *a, const WordNode *b);
+void print_word_list(const LetterList *list);
 void print_all_word_lists(void);
-void remove_duplicate_words(void);
+
+/* Node table (ids of live nodes) */
+ErrorCode node_table_add(WordNode *node);
+void node_table_remove(const WordNode *node);
+void node_table_clear(void);
+
+/* Word columns (filters and aggregates over all words) */
+bool word_columns_set(const WordNode *node);
+void word_columns_remove(unsigned int id);
+void word_columns_clear(void);
+const char *word_column_name(WordColumn column);
+int parse_word_query(const char *text, QueryCondition *conditions,
+                     int max_conditions);
+int run_word_query(const QueryCondition *conditions, int condition_count,
+                   WordNode **results, int max_results);
+void compute_word_histogram(WordColumn column, int bins[HISTOGRAM_BINS]);
+
+/* Word index (hash lookup on clean words) */
+unsigned int hash_word(const char *word);
+ErrorCode word_index_insert(WordNode *node);
+void word_index_remove(const WordNode *node);
+WordNode *word_index_find(const char *word);
+void word_index_clear(void);
+
+/* Bucket table operations */
+WordBucket *bucket_table_find(const BucketTable *table, const char *key);
+WordBucket *bucket_table_add(BucketTable *table, const char *key,
+                             WordNode *node);
+void bucket_table_remove(BucketTable *table, const char *key,
+                         const WordNode *node);
+void bucket_table_clear(BucketTable *table);
+WordBucket *bucket_table_find_packed(const BucketTable *table,
+                                     const PackedWord *key);
+WordBucket *bucket_table_add_packed(BucketTable *table, const PackedWord *key,
+                                    WordNode *node);
+void bucket_table_remove_packed(BucketTable *table, const PackedWord *key,
+                                const WordNode *node);
+
+/* Packed words */
+bool pack_word(const char *word, PackedWord *packed);
+bool packed_word_is_set(const PackedWord *packed);
+void mask_packed_letter(const PackedWord *packed, int position,
+                        PackedWord *pattern);
+unsigned int hash_packed_word(const PackedWord *packed);
+bool packed_words_equal(const PackedWord *a, const PackedWord *b);
+int packed_word_distance(const PackedWord *a, const PackedWord *b);
+bool same_word(const WordNode *a, const WordNode *b);
 
 /* File operations */
-int load_words_from_file(const char *filename);
-bool save_word_to_file(const char *word);
+const char *map_file(const char *filename, size_t *size);
+void unmap_file(const char *data, size_t size);
+int load_words_from_file(const char *filename, int *duplicates);
 bool save_all_words_to_file(void);
 
+/* Edit journal */
+bool append_journal_record(JournalOperation operation, const char *word);
+bool append_journal_records(JournalOperation operation,
+                            const char *const *words, size_t count);
+int replay_journal(const char *filename, int *word_delta, bool *torn);
+long get_journal_size(void);
+bool compact_words_file(void);
+
+/* Batch edits */
+int insert_word_batch(const char *const *words, size_t count,
+                      BatchResult *result);
+int delete_word_batch(const char *const *words, size_t count,
+                      BatchResult *result);
+int import_words_from_file(const char *filename, BatchResult *result);
+int delete_words_from_file(const char *filename, BatchResult *result);
+
+/* Snapshot operations */
+bool load_snapshot(const char *snapshot_path, const char *words_path,
+                   const char *journal_path, int *word_count);
+bool save_snapshot(const char *snapshot_path, const char *words_path,
+                   const char *journal_path, int word_count);
+bool is_snapshot_current(const char *snapshot_path, const char *words_path,
+                         const char *journal_path);
+
+/* Thread pool (work stealing over independent loop iterations) */
+bool start_thread_pool(int thread_count);
+void stop_thread_pool(void);
+int get_thread_pool_size(void);
+void run_parallel_loops(const ParallelLoop *loops, int loop_count);
+
 /* Relationship creation */
 int create_subword_links(void);
-int create_verb_form_links(void);
+int create_inflection_links(void);
+int create_add_one_char_links(void);
 int create_lexically_close_links(void);
 int create_anagram_links(void);
+int find_lexically_close_words(const char *word, WordNode **results,
+                               int max_results);
+void rebuild_relationships(void);
+void free_relationship_indexes(void);
+void restore_relationship_links(WordNode *node,
+                                WordNode *const targets[RELATION_COUNT]);
+void ensure_relationship_indexes(void);
+void ensure_anagram_classes(void);
+
+/* Lazy relationships: links computed on first use */
+void defer_relationships(void);
+void refresh_relationships(void);
+bool relationships_deferred(void);
+void ensure_relationship_links(void);
+void ensure_relation_links(RelationKind kind);
+void ensure_word_links(WordNode *node);
+
+/* Incremental relationship maintenance */
+void add_word_relationships(WordNode *node);
+void remove_word_relationships(WordNode *node);
+void update_link_statistics(Statistics *stats);
 
 /* Relationship display */
 void print_subword_chains(void);
 void print_verb_forms(void);
+void print_inflections(void);
+void print_add_one_char_chains(void);
 void print_lexically_close_words(void);
 void print_anagrams(void);
 
-/* Verb form generation */
+/* Inflected form generation */
 char *generate_ing_form(const char *verb);
 char *generate_ed_form(const char *verb);
+bool generate_ing_form_into(const char *verb, char *ing_form, size_t size);
+bool generate_ed_form_into(const char *verb, char *ed_form, size_t size);
+bool generate_s_form_into(const char *word, char *s_form, size_t size);
+bool generate_er_form_into(const char *word, char *er_form, size_t size);
+bool generate_est_form_into(const char *word, char *est_form, size_t size);
+bool generate_inflection_into(const char *word, Inflection inflection,
+                              char *form, size_t size);
 
 /* Word comparison */
 bool is_subword(const char *smaller, const char *larger);
@@ -0,0 +1,56 @@
+/**
+ * Irregular Forms
+ * Table layout and hash shared by the table generator and inflections.c
+ *
+ * tools/gen_irregular_forms.c reads data/irregular_forms.txt and writes
+ * a header holding a perfect hash table of IrregularWord entries. The
+ * words are spread over buckets, and each bucket has a displacement
+ * chosen by the generator so that every word of the data file lands in a
+ * slot of its own. A lookup is therefore one hash of the word and one
+ * string compare against the slot it selects.
+ */
+
+#ifndef IRREGULAR_FORMS_H
+#define IRREGULAR_FORMS_H
+
+#include <stdint.h>
+
+/* Forms per word: -ed, -ing, -s, -er, -est, in Inflection order */
+#define IRREGULAR_FORM_COUNT 5
+
+/* Displacements pack two 16-bit offsets, which bounds the table size */
+#define IRREGULAR_WORD_MAX_SLOTS 65536
+
+typedef struct {
+  const char *word;                        /* NULL in unused slots */
+  const char *forms[IRREGULAR_FORM_COUNT]; /* NULL where the rules apply */
+} IrregularWord;
+
+/* FNV-1a with a final avalanche, so that every key bit reaches all bits */
+static inline uint64_t hash_irregular_word(const char *word, uint64_t seed) {
+  uint64_t h = UINT64_C(0xCBF29CE484222325) ^ seed;
+  for (; *word != '\0'; word++) {
+    h = (h ^ (unsigned char)*word) * UINT64_C(0x100000001B3);
+  }
+  h ^= h >> 33;
+  h *= UINT64_C(0xFF51AFD7ED558CCD);
+  h ^= h >> 33;
+  return h;
+}
+
+static inline uint32_t irregular_word_bucket(uint64_t hash, uint32_t buckets) {
+  return (uint32_t)((hash * UINT64_C(0x9E3779B97F4A7C15)) >> 32) % buckets;
+}
+
+/* Slot of a word: (f1 + d0 * f2 + d1) mod slots, with f1, f2 from its hash */
+static inline uint32_t irregular_word_slot(uint64_t hash,
+                                           uint32_t displacement,
+                                           uint32_t slots) {
+  uint64_t f1 = (uint32_t)hash % slots;
+  uint64_t f2 = (uint32_t)(hash >> 32) % slots;
+  uint64_t d0 = displacement >> 16;
+  uint64_t d1 = displacement & 0xFFFFu;
+  return (uint32_t)((f1 + d0 * f2 + d1) % slots);
+}
+
+#endif /* IRREGULAR_FORMS_H */
@@ -19,7 +19,13 @@ typedef enum {
   MENU_INSERT_WORD = 6,
   MENU_DELETE_WORD = 7,
   MENU_PRINT_STATS = 8,
-  MENU_EXIT = 9
+  MENU_EXIT = 9,
+  MENU_COMPACT_WORDS_FILE = 10,
+  MENU_IMPORT_WORDS = 11,
+  MENU_DELETE_WORDS = 12,
+  MENU_QUERY_WORDS = 13,
+  MENU_PRINT_HISTOGRAMS = 14,
+  MENU_PRINT_INFLECTIONS = 15
 } MenuChoice;
 
 /* UI functions */
@@ -0,0 +1,154 @@
+/**
+ * Word Arena
+ * Chunked bump allocator owning all per-word storage
+ *
+ * Nodes, their strings and backlink arrays are carved out of large
+ * chunks. Released blocks go onto per-size free lists and are reused by
+ * later allocations of the same size (e.g. a deleted node by the next
+ * inserted one). Everything is returned to the system at once by
+ * arena_release_all.
+ *
+ * The same allocator backs other structures with many small blocks that
+ * are dropped together, such as the buckets of each bucket table; those
+ * own an Arena of their own and use the *_in functions.
+ */
+
+#include "../../include/english_words.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_CHUNK_SIZE (64 * 1024)
+#define ARENA_ALIGNMENT 8
+
+struct ArenaChunk {
+  ArenaChunk *next;
+  size_t size;
+  size_t used;
+  unsigned char data[];
+};
+
+struct FreeBlock {
+  FreeBlock *next;
+};
+
+/* Per-word storage */
+static Arena g_word_arena;
+
+static size_t round_size(size_t size) {
+  if (size == 0) {
+    size = 1;
+  }
+  return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+/* Allocation */
+
+void *arena_alloc_in(Arena *arena, size_t size) {
+  size = round_size(size);
+  size_t size_class = size / ARENA_ALIGNMENT - 1;
+
+  /* Reuse a released block of the same size first */
+  if (size_class < ARENA_SIZE_CLASSES &&
+      arena->free_lists[size_class] != NULL) {
+    FreeBlock *block = arena->free_lists[size_class];
+    arena->free_lists[size_class] = block->next;
+    arena->bytes_free -= size;
+    arena->bytes_used += size;
+    return block;
+  }
+
+  ArenaChunk *current = arena->chunks;
+  if (current == NULL || current->used + size > current->size) {
+    size_t chunk_size = size > ARENA_CHUNK_SIZE ? size : ARENA_CHUNK_SIZE;
+    ArenaChunk *chunk = (ArenaChunk *)malloc(sizeof(ArenaChunk) + chunk_size);
+    if (chunk == NULL) {
+      fprintf(stderr, "Error: Unable to allocate memory for arena.\n");
+      return NULL;
+    }
+
+    /* The tail of the previous chunk stays unused */
+    if (current != NULL) {
+      arena->bytes_free += current->size - current->used;
+      current->used = current->size;
+    }
+
+    chunk->next = current;
+    chunk->size = chunk_size;
+    chunk->used = 0;
+    arena->chunks = current = chunk;
+    arena->bytes_reserved += chunk_size;
+  }
+
+  void *ptr = current->data + current->used;
+  current->used += size;
+  arena->bytes_used += size;
+  return ptr;
+}
+
+void *arena_alloc(size_t size) { return arena_alloc_in(&g_word_arena, size); }
+
+char *arena_copy_string(const char *text) {
+  if (text == NULL) {
+    return NULL;
+  }
+
+  size_t len = strlen(text);
+  char *copy = (char *)arena_alloc(len + 1);
+  if (copy != NULL) {
+    memcpy(copy, text, len + 1);
+  }
+  return copy;
+}
+
+void arena_free_in(Arena *arena, void *ptr, size_t size) {
+  if (ptr == NULL) {
+    return;
+  }
+
+  size = round_size(size);
+  size_t size_class = size / ARENA_ALIGNMENT - 1;
+
+  arena->bytes_used -= size;
+  arena->bytes_free += size;
+
+  /* Larger blocks stay unused until the arena is released */
+  if (size_class < ARENA_SIZE_CLASSES) {
+    FreeBlock *block = (FreeBlock *)ptr;
+    block->next = arena->free_lists[size_class];
+    arena->free_lists[size_class] = block;
+  }
+}
+
+void arena_free(void *ptr, size_t size) {
+  arena_free_in(&g_word_arena, ptr, size);
+}
+
+/* Size actually taken by a block, so callers can lay out arena blocks */
+size_t arena_block_size(size_t size) { return round_size(size); }
+
+/* Bulk release */
+
+void arena_release(Arena *arena) {
+  while (arena->chunks != NULL) {
+    ArenaChunk *next = arena->chunks->next;
+    free(arena->chunks);
+    arena->chunks = next;
+  }
+
+  memset(arena, 0, sizeof(Arena));
+}
+
+void arena_release_all(void) { arena_release(&g_word_arena); }
+
+/* Statistics */
+
+void get_arena_statistics(ArenaStatistics *stats) {
+  if (stats == NULL) {
+    return;
+  }
+
+  stats->bytes_reserved = g_word_arena.bytes_reserved;
+  stats->bytes_used = g_word_arena.bytes_used;
+  stats->bytes_free = g_word_arena.bytes_free;
+}
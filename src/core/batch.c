@@ -0,0 +1,182 @@
+/**
+ * Batch Edits
+ * Inserting or deleting many words at once
+ *
+ * A batch is validated and deduplicated word by word, applied to the
+ * lists, persisted with a single journal write and then linked. Small
+ * batches are linked incrementally; larger ones are applied without
+ * touching relationships and followed by one full rebuild, which in
+ * lazy mode just drops every link to be computed again on first use.
+ */
+
+#include "../../include/english_words.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Largest batch still cheaper to link word by word than to rebuild */
+#define BATCH_INCREMENTAL_LIMIT 256
+
+static void reset_batch_result(BatchResult *result) {
+  memset(result, 0, sizeof(BatchResult));
+}
+
+/* Insertion */
+
+int insert_word_batch(const char *const *words, size_t count,
+                      BatchResult *result) {
+  if (words == NULL || result == NULL) {
+    return -1;
+  }
+
+  reset_batch_result(result);
+
+  const char **inserted =
+      (const char **)malloc((count + 1) * sizeof(const char *));
+  if (inserted == NULL) {
+    fprintf(stderr, "Error: Unable to allocate memory for batch.\n");
+    return -1;
+  }
+
+  bool incremental = count <= BATCH_INCREMENTAL_LIMIT;
+
+  /* Lazily built indexes must not pick up words of this batch */
+  if (incremental) {
+    ensure_relationship_indexes();
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    const char *word = words[i];
+    if (word == NULL || !is_valid_word_format(word)) {
+      result->invalid++;
+      continue;
+    }
+
+    char clean[MAX_WORD_LENGTH];
+    if (!remove_slashes_into(word, clean, sizeof(clean))) {
+      result->invalid++;
+      continue;
+    }
+
+    /* Words already known and repeats within the batch are rejected */
+    int index = get_word_letter_index(clean);
+    ErrorCode inserted_result =
+        insert_word_sorted_by_length(&g_word_lists[index], word);
+    WordNode *node = inserted_result == SUCCESS ? search_word(clean) : NULL;
+
+    if (inserted_result == ERROR_WORD_EXISTS) {
+      result->duplicates++;
+      continue;
+    }
+    if (node == NULL) {
+      result->invalid++;
+      continue;
+    }
+
+    if (incremental) {
+      add_word_relationships(node);
+    }
+    inserted[result->applied++] = word;
+  }
+
+  if (!incremental && result->applied > 0) {
+    refresh_relationships();
+  }
+
+  result->saved = result->applied == 0 ||
+                  append_journal_records(JOURNAL_INSERT, inserted,
+                                         (size_t)result->applied);
+  free(inserted);
+  return result->applied;
+}
+
+/* Deletion */
+
+static int compare_batch_nodes(const void *a, const void *b) {
+  return compare_word_order(*(WordNode *const *)a, *(WordNode *const *)b);
+}
+
+int delete_word_batch(const char *const *words, size_t count,
+                      BatchResult *result) {
+  if (words == NULL || result == NULL) {
+    return -1;
+  }
+
+  reset_batch_result(result);
+
+  WordNode **nodes = (WordNode **)malloc((count + 1) * sizeof(WordNode *));
+  const char **deleted =
+      (const char **)malloc((count + 1) * sizeof(const char *));
+  if (nodes == NULL || deleted == NULL) {
+    fprintf(stderr, "Error: Unable to allocate memory for batch.\n");
+    free(nodes);
+    free(deleted);
+    return -1;
+  }
+
+  /* Resolve the whole batch first, dropping unknown words */
+  size_t found = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (words[i] == NULL || !is_valid_word_format(words[i])) {
+      result->invalid++;
+      continue;
+    }
+
+    char clean[MAX_WORD_LENGTH];
+    if (!remove_slashes_into(words[i], clean, sizeof(clean))) {
+      result->invalid++;
+      continue;
+    }
+
+    WordNode *node = search_word(clean);
+
+    if (node == NULL) {
+      result->missing++;
+    } else {
+      nodes[found++] = node;
+    }
+  }
+
+  /* Sorting in list order brings repeats of a word together */
+  qsort(nodes, found, sizeof(WordNode *), compare_batch_nodes);
+
+  size_t unique = 0;
+  for (size_t i = 0; i < found; i++) {
+    if (unique > 0 && nodes[unique - 1] == nodes[i]) {
+      result->duplicates++;
+      continue;
+    }
+    deleted[unique] = nodes[i]->clean_word;
+    nodes[unique++] = nodes[i];
+  }
+  found = unique;
+
+  /* Journal the deletions while the words are still alive */
+  result->saved = found == 0 ||
+                  append_journal_records(JOURNAL_DELETE, deleted, found);
+
+  bool incremental = found <= BATCH_INCREMENTAL_LIMIT;
+
+  for (size_t i = 0; i < found; i++) {
+    char clean[MAX_WORD_LENGTH];
+    strcpy(clean, nodes[i]->clean_word);
+
+    /* A full rebuild below replaces every link, dangling ones included */
+    if (incremental) {
+      remove_word_relationships(nodes[i]);
+    }
+
+    if (delete_word_from_list(
+            &g_word_lists[get_word_letter_index(clean)], clean)) {
+      result->applied++;
+    }
+  }
+
+  if (!incremental) {
+    refresh_relationships();
+  }
+
+  free(nodes);
+  free(deleted);
+  return result->applied;
+}
@@ -0,0 +1,313 @@
+/**
+ * Bucket Table
+ * Hash table mapping a string key to the bucket of nodes sharing it
+ *
+ * Used to group words by a derived key (sorted signature, masked pattern,
+ * ...) in a single pass. Buckets are allocated apart from the slots so
+ * that pointers to them stay valid when the table grows, and nodes keep
+ * the order in which they were added. Keys of short words can be given
+ * packed instead of as strings; the packed key is stored in the bucket
+ * itself.
+ *
+ * Buckets, string keys and node arrays come from an arena owned by the
+ * table, so filling a table costs a heap allocation per arena chunk rather
+ * than several per bucket, and clearing it releases the chunks at once.
+ * Tables filled concurrently each use only their own arena.
+ */
+
+#include "../../include/english_words.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BUCKET_TABLE_INITIAL_CAPACITY 256
+#define BUCKET_INITIAL_CAPACITY 2
+
+/* A key as given by the caller: a string, or a packed word if text is NULL */
+typedef struct {
+  const char *text;
+  const PackedWord *packed;
+  unsigned int hash;
+} BucketKey;
+
+static BucketKey string_key(const char *text) {
+  BucketKey key = {text, NULL, hash_word(text)};
+  return key;
+}
+
+static BucketKey packed_key(const PackedWord *packed) {
+  BucketKey key = {NULL, packed, hash_packed_word(packed)};
+  return key;
+}
+
+static bool bucket_has_key(const WordBucket *bucket, const BucketKey *key) {
+  if (bucket->hash != key->hash) {
+    return false;
+  }
+  if (key->text != NULL) {
+    return bucket->key != NULL && strcmp(bucket->key, key->text) == 0;
+  }
+  return bucket->key == NULL &&
+         packed_words_equal(&bucket->packed_key, key->packed);
+}
+
+/* Table management */
+
+static void place_bucket(WordBucket **slots, size_t capacity,
+                         WordBucket *bucket) {
+  size_t mask = capacity - 1;
+  size_t i = bucket->hash & mask;
+
+  while (slots[i] != NULL) {
+    i = (i + 1) & mask;
+  }
+  slots[i] = bucket;
+}
+
+static bool grow_table(BucketTable *table) {
+  size_t new_capacity = table->capacity == 0 ? BUCKET_TABLE_INITIAL_CAPACITY
+                                             : table->capacity * 2;
+
+  WordBucket **new_slots =
+      (WordBucket **)calloc(new_capacity, sizeof(WordBucket *));
+  if (new_slots == NULL) {
+    fprintf(stderr, "Error: Unable to allocate memory for bucket table.\n");
+    return false;
+  }
+
+  for (size_t i = 0; i < table->capacity; i++) {
+    if (table->slots[i] != NULL) {
+      place_bucket(new_slots, new_capacity, table->slots[i]);
+    }
+  }
+
+  free(table->slots);
+  table->slots = new_slots;
+  table->capacity = new_capacity;
+  return true;
+}
+
+static size_t find_slot(const BucketTable *table, const BucketKey *key) {
+  size_t mask = table->capacity - 1;
+  size_t i = key->hash & mask;
+
+  while (table->slots[i] != NULL) {
+    if (bucket_has_key(table->slots[i], key)) {
+      return i;
+    }
+    i = (i + 1) & mask;
+  }
+  return i;
+}
+
+static void free_bucket(BucketTable *table, WordBucket *bucket) {
+  if (bucket->key != NULL) {
+    arena_free_in(&table->storage, bucket->key, strlen(bucket->key) + 1);
+  }
+  arena_free_in(&table->storage, bucket->nodes,
+                (size_t)bucket->capacity * sizeof(WordNode *));
+  arena_free_in(&table->storage, bucket, sizeof(WordBucket));
+}
+
+static WordBucket *create_bucket(BucketTable *table, const BucketKey *key) {
+  WordBucket *bucket =
+      (WordBucket *)arena_alloc_in(&table->storage, sizeof(WordBucket));
+  if (bucket == NULL) {
+    return NULL;
+  }
+  memset(bucket, 0, sizeof(WordBucket));
+
+  if (key->text != NULL) {
+    size_t size = strlen(key->text) + 1;
+    bucket->key = (char *)arena_alloc_in(&table->storage, size);
+    if (bucket->key == NULL) {
+      arena_free_in(&table->storage, bucket, sizeof(WordBucket));
+      return NULL;
+    }
+    memcpy(bucket->key, key->text, size);
+  } else {
+    bucket->packed_key = *key->packed;
+  }
+
+  bucket->hash = key->hash;
+  return bucket;
+}
+
+/* Keyed operations */
+
+static WordBucket *find_bucket(const BucketTable *table,
+                               const BucketKey *key) {
+  if (table->count == 0) {
+    return NULL;
+  }
+
+  return table->slots[find_slot(table, key)];
+}
+
+static WordBucket *add_to_bucket(BucketTable *table, const BucketKey *key,
+                                 WordNode *node) {
+  /* Keep the load factor below 0.7 */
+  if ((table->count + 1) * 10 > table->capacity * 7 && !grow_table(table)) {
+    return NULL;
+  }
+
+  size_t slot = find_slot(table, key);
+  WordBucket *bucket = table->slots[slot];
+
+  if (bucket == NULL) {
+    bucket = create_bucket(table, key);
+    if (bucket == NULL) {
+      fprintf(stderr, "Error: Unable to allocate memory for bucket.\n");
+      return NULL;
+    }
+    table->slots[slot] = bucket;
+    table->count++;
+  }
+
+  if (bucket->count == bucket->capacity) {
+    int new_capacity = bucket->capacity == 0 ? BUCKET_INITIAL_CAPACITY
+                                             : bucket->capacity * 2;
+    WordNode **new_nodes = (WordNode **)arena_alloc_in(
+        &table->storage, (size_t)new_capacity * sizeof(WordNode *));
+    if (new_nodes == NULL) {
+      fprintf(stderr, "Error: Unable to allocate memory for bucket.\n");
+      return NULL;
+    }
+    if (bucket->count > 0) {
+      memcpy(new_nodes, bucket->nodes,
+             (size_t)bucket->count * sizeof(WordNode *));
+    }
+    arena_free_in(&table->storage, bucket->nodes,
+                  (size_t)bucket->capacity * sizeof(WordNode *));
+    bucket->nodes = new_nodes;
+    bucket->capacity = new_capacity;
+  }
+
+  bucket->nodes[bucket->count++] = node;
+  return bucket;
+}
+
+static void remove_from_bucket(BucketTable *table, const BucketKey *key,
+                               const WordNode *node) {
+  if (table->count == 0) {
+    return;
+  }
+
+  size_t i = find_slot(table, key);
+  WordBucket *bucket = table->slots[i];
+  if (bucket == NULL) {
+    return;
+  }
+
+  /* Remove the node while preserving the order of the others */
+  for (int k = 0; k < bucket->count; k++) {
+    if (bucket->nodes[k] == node) {
+      memmove(&bucket->nodes[k], &bucket->nodes[k + 1],
+              (size_t)(bucket->count - k - 1) * sizeof(WordNode *));
+      bucket->count--;
+      break;
+    }
+  }
+
+  if (bucket->count > 0) {
+    return;
+  }
+
+  /* Drop the empty bucket with backward-shift deletion */
+  free_bucket(table, bucket);
+
+  size_t mask = table->capacity - 1;
+  size_t j = i;
+  while (true) {
+    j = (j + 1) & mask;
+    if (table->slots[j] == NULL) {
+      break;
+    }
+
+    size_t home = table->slots[j]->hash & mask;
+    bool home_in_gap = (i <= j) ? (i < home && home <= j)
+                                : (i < home || home <= j);
+    if (!home_in_gap) {
+      table->slots[i] = table->slots[j];
+      i = j;
+    }
+  }
+
+  table->slots[i] = NULL;
+  table->count--;
+}
+
+/* Table operations */
+
+WordBucket *bucket_table_find(const BucketTable *table, const char *key) {
+  if (table == NULL || key == NULL) {
+    return NULL;
+  }
+
+  BucketKey bucket_key = string_key(key);
+  return find_bucket(table, &bucket_key);
+}
+
+WordBucket *bucket_table_add(BucketTable *table, const char *key,
+                             WordNode *node) {
+  if (table == NULL || key == NULL || node == NULL) {
+    return NULL;
+  }
+
+  BucketKey bucket_key = string_key(key);
+  return add_to_bucket(table, &bucket_key, node);
+}
+
+void bucket_table_remove(BucketTable *table, const char *key,
+                         const WordNode *node) {
+  if (table == NULL || key == NULL) {
+    return;
+  }
+
+  BucketKey bucket_key = string_key(key);
+  remove_from_bucket(table, &bucket_key, node);
+}
+
+WordBucket *bucket_table_find_packed(const BucketTable *table,
+                                     const PackedWord *key) {
+  if (table == NULL || key == NULL) {
+    return NULL;
+  }
+
+  BucketKey bucket_key = packed_key(key);
+  return find_bucket(table, &bucket_key);
+}
+
+WordBucket *bucket_table_add_packed(BucketTable *table, const PackedWord *key,
+                                    WordNode *node) {
+  if (table == NULL || key == NULL || node == NULL) {
+    return NULL;
+  }
+
+  BucketKey bucket_key = packed_key(key);
+  return add_to_bucket(table, &bucket_key, node);
+}
+
+void bucket_table_remove_packed(BucketTable *table, const PackedWord *key,
+                                const WordNode *node) {
+  if (table == NULL || key == NULL) {
+    return;
+  }
+
+  BucketKey bucket_key = packed_key(key);
+  remove_from_bucket(table, &bucket_key, node);
+}
+
+void bucket_table_clear(BucketTable *table) {
+  if (table == NULL) {
+    return;
+  }
+
+  /* Buckets are released with the arena, not one by one */
+  arena_release(&table->storage);
+
+  free(table->slots);
+  table->slots = NULL;
+  table->capacity = 0;
+  table->count = 0;
+}
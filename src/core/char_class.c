@@ -0,0 +1,255 @@
+/**
+ * Character Classification
+ * Letter, vowel and slash detection over whole words at a time
+ *
+ * A word is classified into one bitmask per class (bit i for character i),
+ * so validation and counting become mask tests and popcounts. On x86 the
+ * masks are built 16 bytes at a time with SSE2 or 32 with AVX2, picked at
+ * runtime from the CPUID feature bits; elsewhere a scalar loop is used.
+ * Letters are ASCII letters, as isalpha reports in the C locale.
+ */
+
+#include "../../include/english_words.h"
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CHAR_CLASS_X86 1
+#include <immintrin.h>
+#endif
+
+/* Bit i set if letter 'a' + i counts as a vowel (a, e, i, o, u, y) */
+#define VOWEL_LETTERS                                                         \
+  ((1u << ('a' - 'a')) | (1u << ('e' - 'a')) | (1u << ('i' - 'a')) |         \
+   (1u << ('o' - 'a')) | (1u << ('u' - 'a')) | (1u << ('y' - 'a')))
+
+typedef enum {
+  CHAR_KERNEL_SCALAR = 0,
+  CHAR_KERNEL_SSE2,
+  CHAR_KERNEL_AVX2,
+  CHAR_KERNEL_COUNT
+} CharKernel;
+
+/* Bit helpers */
+
+int count_bits(uint64_t bits) {
+#ifdef __GNUC__
+  return __builtin_popcountll(bits);
+#else
+  int count = 0;
+  while (bits != 0) {
+    bits &= bits - 1;
+    count++;
+  }
+  return count;
+#endif
+}
+
+int lowest_bit(uint64_t bits) {
+#ifdef __GNUC__
+  return bits != 0 ? __builtin_ctzll(bits) : -1;
+#else
+  if (bits == 0) {
+    return -1;
+  }
+  int index = 0;
+  while ((bits & 1) == 0) {
+    bits >>= 1;
+    index++;
+  }
+  return index;
+#endif
+}
+
+static uint64_t low_bits(size_t count) {
+  return count >= CHAR_CLASS_WINDOW ? ~(uint64_t)0
+                                    : ((uint64_t)1 << count) - 1;
+}
+
+/* Kernels, each classifying the first blocks of a zero-padded window */
+
+#define CHAR_CLASS_BLOCK 16
+
+static void classify_scalar(const unsigned char *window, int blocks,
+                            CharClasses *classes) {
+  uint64_t letters = 0;
+  uint64_t vowels = 0;
+  uint64_t slashes = 0;
+
+  for (int i = 0; i < blocks * CHAR_CLASS_BLOCK; i++) {
+    uint64_t bit = (uint64_t)1 << i;
+    unsigned int letter = (unsigned int)(window[i] | 0x20) - 'a';
+
+    if (letter < ALPHABET_SIZE) {
+      letters |= bit;
+      if ((VOWEL_LETTERS >> letter) & 1u) {
+        vowels |= bit;
+      }
+    } else if (window[i] == '/') {
+      slashes |= bit;
+    }
+  }
+
+  classes->letters = letters;
+  classes->vowels = vowels;
+  classes->slashes = slashes;
+}
+
+#ifdef CHAR_CLASS_X86
+
+/*
+ * Setting the case bit maps A-Z onto a-z; adding 0x80 - 'a' then moves
+ * a-z to the bottom of the signed byte range, where one signed compare
+ * (the only kind SSE2 has) detects them.
+ */
+__attribute__((target("sse2"))) static void
+classify_sse2(const unsigned char *window, int blocks, CharClasses *classes) {
+  const __m128i case_bit = _mm_set1_epi8(0x20);
+  const __m128i letter_shift = _mm_set1_epi8((char)(0x80 - 'a'));
+  const __m128i letter_limit = _mm_set1_epi8((char)(-128 + ALPHABET_SIZE));
+
+  uint64_t letters = 0;
+  uint64_t vowels = 0;
+  uint64_t slashes = 0;
+
+  for (int offset = 0; offset < blocks * CHAR_CLASS_BLOCK; offset += 16) {
+    __m128i c = _mm_loadu_si128((const __m128i *)(window + offset));
+    __m128i lower = _mm_or_si128(c, case_bit);
+
+    __m128i letter = _mm_cmplt_epi8(_mm_add_epi8(lower, letter_shift),
+                                    letter_limit);
+    __m128i vowel = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('a')),
+                     _mm_cmpeq_epi8(lower, _mm_set1_epi8('e'))),
+        _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('i')),
+                     _mm_cmpeq_epi8(lower, _mm_set1_epi8('o'))));
+    vowel = _mm_or_si128(
+        vowel, _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('u')),
+                            _mm_cmpeq_epi8(lower, _mm_set1_epi8('y'))));
+    __m128i slash = _mm_cmpeq_epi8(c, _mm_set1_epi8('/'));
+
+    letters |= (uint64_t)(unsigned int)_mm_movemask_epi8(letter) << offset;
+    vowels |= (uint64_t)(unsigned int)_mm_movemask_epi8(vowel) << offset;
+    slashes |= (uint64_t)(unsigned int)_mm_movemask_epi8(slash) << offset;
+  }
+
+  classes->letters = letters;
+  classes->vowels = vowels;
+  classes->slashes = slashes;
+}
+
+__attribute__((target("avx2"))) static void
+classify_avx2(const unsigned char *window, int blocks, CharClasses *classes) {
+  const __m256i case_bit = _mm256_set1_epi8(0x20);
+  const __m256i letter_shift = _mm256_set1_epi8((char)(0x80 - 'a'));
+  const __m256i letter_limit = _mm256_set1_epi8((char)(-128 + ALPHABET_SIZE));
+
+  uint64_t letters = 0;
+  uint64_t vowels = 0;
+  uint64_t slashes = 0;
+
+  /* An odd block left over is read as a full pair; the window has room */
+  for (int offset = 0; offset < blocks * CHAR_CLASS_BLOCK; offset += 32) {
+    __m256i c = _mm256_loadu_si256((const __m256i *)(window + offset));
+    __m256i lower = _mm256_or_si256(c, case_bit);
+
+    /* AVX2 only has a greater-than compare, so the operands are swapped */
+    __m256i letter = _mm256_cmpgt_epi8(
+        letter_limit, _mm256_add_epi8(lower, letter_shift));
+    __m256i vowel = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('a')),
+                        _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('e'))),
+        _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('i')),
+                        _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('o'))));
+    vowel = _mm256_or_si256(
+        vowel,
+        _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('u')),
+                        _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('y'))));
+    __m256i slash = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('/'));
+
+    letters |= (uint64_t)(unsigned int)_mm256_movemask_epi8(letter) << offset;
+    vowels |= (uint64_t)(unsigned int)_mm256_movemask_epi8(vowel) << offset;
+    slashes |= (uint64_t)(unsigned int)_mm256_movemask_epi8(slash) << offset;
+  }
+
+  classes->letters = letters;
+  classes->vowels = vowels;
+  classes->slashes = slashes;
+}
+
+#endif /* CHAR_CLASS_X86 */
+
+/* Dispatch */
+
+static bool kernel_available(CharKernel kernel) {
+  switch (kernel) {
+  case CHAR_KERNEL_SCALAR:
+    return true;
+#ifdef CHAR_CLASS_X86
+  case CHAR_KERNEL_SSE2:
+    return __builtin_cpu_supports("sse2");
+  case CHAR_KERNEL_AVX2:
+    return __builtin_cpu_supports("avx2");
+#endif
+  default:
+    return false;
+  }
+}
+
+static void classify_with(CharKernel kernel, const char *text, size_t length,
+                          CharClasses *classes) {
+  if (length > CHAR_CLASS_WINDOW) {
+    length = CHAR_CLASS_WINDOW;
+  }
+
+  /*
+   * Only the blocks covering the text are classified, so short words stay
+   * cheap. Padding with zero bytes lets every kernel read whole blocks.
+   */
+  int blocks = length == 0 ? 1
+                           : (int)((length + CHAR_CLASS_BLOCK - 1) /
+                                   CHAR_CLASS_BLOCK);
+  unsigned char window[CHAR_CLASS_WINDOW];
+  memcpy(window, text, length);
+  memset(window + length, 0, CHAR_CLASS_WINDOW - length);
+
+  switch (kernel) {
+#ifdef CHAR_CLASS_X86
+  case CHAR_KERNEL_AVX2:
+    /* A single block is not worth the wider registers */
+    if (blocks == 1) {
+      classify_sse2(window, blocks, classes);
+    } else {
+      classify_avx2(window, blocks, classes);
+    }
+    break;
+  case CHAR_KERNEL_SSE2:
+    classify_sse2(window, blocks, classes);
+    break;
+#endif
+  default:
+    classify_scalar(window, blocks, classes);
+    break;
+  }
+
+  uint64_t valid = low_bits(length);
+  classes->letters &= valid;
+  classes->vowels &= valid;
+  classes->slashes &= valid;
+}
+
+void classify_characters(const char *text, size_t length,
+                         CharClasses *classes) {
+  if (text == NULL || classes == NULL) {
+    return;
+  }
+
+  /* The feature bits are read from CPUID once, at program start */
+  CharKernel kernel = CHAR_KERNEL_SCALAR;
+  if (kernel_available(CHAR_KERNEL_AVX2)) {
+    kernel = CHAR_KERNEL_AVX2;
+  } else if (kernel_available(CHAR_KERNEL_SSE2)) {
+    kernel = CHAR_KERNEL_SSE2;
+  }
+
+  classify_with(kernel, text, length, classes);
+}
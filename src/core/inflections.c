@@ -0,0 +1,317 @@
+/**
+ * Inflected Form Generation
+ * Generate -ed, -ing, -s, -er and -est forms of words
+ *
+ * Improvements:
+ * - Better buffer size calculations
+ * - More comprehensive irregular verb handling
+ * - Safer string operations
+ *
+ * The *_into functions write into a caller-provided buffer, so the
+ * relationship searches generate forms without touching the heap; the
+ * allocating versions are thin wrappers kept for other callers.
+ *
+ * Irregular and invariant forms are not in the code: they are listed in
+ * data/irregular_forms.txt, which the build compiles into a perfect hash
+ * table (build/gen/irregular_forms_table.h). Each word is looked up with
+ * one hash and one compare before the rules are applied.
+ *
+ * Words carry no part of speech, so every form is generated for every
+ * word; a form only becomes a link when the dictionary holds it. The -s
+ * form stands for both the third person of verbs and the plural of nouns,
+ * which the regular rules spell the same way.
+ */
+
+#include "../../include/english_words.h"
+#include "../../include/irregular_forms.h"
+#include "irregular_forms_table.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* The data file has one column per inflection */
+typedef char irregular_columns_match_inflections
+    [IRREGULAR_FORM_COUNT == INFLECTION_COUNT ? 1 : -1];
+
+/* Irregular forms */
+
+/* The listed form of word for inflection, or NULL if the rules apply */
+static const char *find_irregular_form(const char *word,
+                                       Inflection inflection) {
+  uint64_t hash = hash_irregular_word(word, IRREGULAR_WORD_SEED);
+  uint32_t bucket = irregular_word_bucket(hash, IRREGULAR_WORD_BUCKETS);
+  const IrregularWord *entry =
+      &g_irregular_words[irregular_word_slot(
+          hash, g_irregular_word_displacements[bucket], IRREGULAR_WORD_SLOTS)];
+
+  if (entry->word == NULL || strcmp(entry->word, word) != 0) {
+    return NULL;
+  }
+  return entry->forms[inflection];
+}
+
+static bool copy_form(const char *form, char *buffer, size_t size) {
+  size_t len = strlen(form);
+  if (len + 1 > size) {
+    return false;
+  }
+  memcpy(buffer, form, len + 1);
+  return true;
+}
+
+/* Rule-based generation */
+
+/* Consonant-vowel-consonant ending whose last consonant doubles */
+static bool ends_with_cvc(const char *word, size_t len) {
+  return len >= 3 && word[len - 1] != 'w' && word[len - 1] != 'x' &&
+         word[len - 1] != 'y' && is_consonant(word[len - 1]) &&
+         is_vowel(word[len - 2]) && is_consonant(word[len - 3]);
+}
+
+/* The first keep letters of word, the last of them again if doubled, then
+ * suffix */
+static void join_form(char *form, const char *word, size_t keep,
+                      bool doubled, const char *suffix) {
+  size_t len = keep;
+  memcpy(form, word, keep);
+  if (doubled) {
+    form[len++] = word[keep - 1];
+  }
+  strcpy(form + len, suffix);
+}
+
+bool generate_ing_form_into(const char *verb, char *ing_form, size_t size) {
+  if (verb == NULL || verb[0] == '\0' || ing_form == NULL) {
+    return false;
+  }
+
+  size_t len = strlen(verb);
+  if (len + 5 > size) { /* Doubling + "ing" + null */
+    return false;
+  }
+
+  /* Irregular forms: "be" -> "being", ... */
+  const char *irregular = find_irregular_form(verb, INFLECTION_ING);
+  if (irregular != NULL) {
+    return copy_form(irregular, ing_form, size);
+  }
+
+  /* If verb ends with 'ie', replace with 'ying' */
+  if (len >= 2 && verb[len - 2] == 'i' && verb[len - 1] == 'e') {
+    memcpy(ing_form, verb, len - 2);
+    ing_form[len - 2] = '\0';
+    strcat(ing_form, "ying");
+  }
+  /* If verb ends with 'e' (but not 'ee', 'oe', 'ye') */
+  else if (verb[len - 1] == 'e') {
+    if (len >= 2 && (verb[len - 2] == 'e' || verb[len - 2] == 'o' ||
+                     verb[len - 2] == 'y')) {
+      /* Ends with "ee", "oe", or "ye": just add "ing" */
+      strcpy(ing_form, verb);
+      strcat(ing_form, "ing");
+    } else {
+      /* Replace 'e' with "ing" */
+      memcpy(ing_form, verb, len - 1);
+      ing_form[len - 1] = '\0';
+      strcat(ing_form, "ing");
+    }
+  }
+  /* CVC pattern: consonant-vowel-consonant (but not w, x, y at end) */
+  else if (ends_with_cvc(verb, len)) {
+    /* Double the last consonant and add "ing" */
+    strcpy(ing_form, verb);
+    ing_form[len] = verb[len - 1];
+    ing_form[len + 1] = '\0';
+    strcat(ing_form, "ing");
+  } else {
+    /* Default: just add "ing" */
+    strcpy(ing_form, verb);
+    strcat(ing_form, "ing");
+  }
+
+  return true;
+}
+
+bool generate_ed_form_into(const char *verb, char *ed_form, size_t size) {
+  if (verb == NULL || verb[0] == '\0' || ed_form == NULL) {
+    return false;
+  }
+
+  size_t len = strlen(verb);
+  if (len + 4 > size) { /* Doubling + "ed" + null */
+    return false;
+  }
+
+  /* Irregular and invariant forms: "go" -> "gone", "cut" -> "cut", ... */
+  const char *irregular = find_irregular_form(verb, INFLECTION_ED);
+  if (irregular != NULL) {
+    return copy_form(irregular, ed_form, size);
+  }
+
+  /* If verb already ends with "ed" */
+  if (len >= 2 && verb[len - 1] == 'd' && verb[len - 2] == 'e') {
+    strcpy(ed_form, verb);
+  }
+  /* If verb ends with 'e' (not "ee") */
+  else if (verb[len - 1] == 'e') {
+    if (len >= 2 && verb[len - 2] == 'e') {
+      /* Ends with "ee": just add "d" */
+      strcpy(ed_form, verb);
+      strcat(ed_form, "d");
+    } else {
+      /* Ends with 'e': just add "d" */
+      strcpy(ed_form, verb);
+      strcat(ed_form, "d");
+    }
+  }
+  /* If verb ends with consonant + 'y' */
+  else if (len >= 2 && verb[len - 1] == 'y' && is_consonant(verb[len - 2])) {
+    memcpy(ed_form, verb, len - 1);
+    ed_form[len - 1] = '\0';
+    strcat(ed_form, "ied");
+  }
+  /* CVC pattern: consonant-vowel-consonant (but not w, x, y at end) */
+  else if (ends_with_cvc(verb, len)) {
+    /* Double the last consonant and add "ed" */
+    strcpy(ed_form, verb);
+    ed_form[len] = verb[len - 1];
+    ed_form[len + 1] = '\0';
+    strcat(ed_form, "ed");
+  } else {
+    /* Default: just add "ed" */
+    strcpy(ed_form, verb);
+    strcat(ed_form, "ed");
+  }
+
+  return true;
+}
+
+bool generate_s_form_into(const char *word, char *s_form, size_t size) {
+  if (word == NULL || word[0] == '\0' || s_form == NULL) {
+    return false;
+  }
+
+  size_t len = strlen(word);
+  if (len + 3 > size) { /* "ies" in place of 'y', or "es" + null */
+    return false;
+  }
+
+  /* Irregular forms: "child" -> "children", "have" -> "has", ... */
+  const char *irregular = find_irregular_form(word, INFLECTION_S);
+  if (irregular != NULL) {
+    return copy_form(irregular, s_form, size);
+  }
+
+  char last = word[len - 1];
+  char before = len >= 2 ? word[len - 2] : '\0';
+
+  /* Sibilant endings (-s, -x, -z, -ch, -sh) take "es" */
+  if (last == 's' || last == 'x' || last == 'z' ||
+      (last == 'h' && (before == 'c' || before == 's'))) {
+    join_form(s_form, word, len, false, "es");
+  }
+  /* Consonant + 'y': "city" -> "cities" */
+  else if (last == 'y' && len >= 2 && is_consonant(before)) {
+    join_form(s_form, word, len - 1, false, "ies");
+  }
+  /* Consonant + 'o': "go" -> "goes" */
+  else if (last == 'o' && len >= 2 && is_consonant(before)) {
+    join_form(s_form, word, len, false, "es");
+  } else {
+    join_form(s_form, word, len, false, "s");
+  }
+
+  return true;
+}
+
+/* Comparative and superlative, which share their spelling rules */
+static bool generate_degree_form(const char *word, Inflection inflection,
+                                 const char *suffix, char *form,
+                                 size_t size) {
+  if (word == NULL || word[0] == '\0' || form == NULL) {
+    return false;
+  }
+
+  size_t len = strlen(word);
+  if (len + strlen(suffix) + 2 > size) { /* Doubling + suffix + null */
+    return false;
+  }
+
+  /* Irregular forms: "good" -> "better" -> "best", ... */
+  const char *irregular = find_irregular_form(word, inflection);
+  if (irregular != NULL) {
+    return copy_form(irregular, form, size);
+  }
+
+  /* Ends with 'e': "large" -> "larger", dropping the suffix's own 'e' */
+  if (word[len - 1] == 'e') {
+    join_form(form, word, len, false, suffix + 1);
+  }
+  /* Consonant + 'y': "happy" -> "happier" */
+  else if (len >= 2 && word[len - 1] == 'y' && is_consonant(word[len - 2])) {
+    join_form(form, word, len - 1, false, "i");
+    strcat(form, suffix);
+  }
+  /* CVC pattern: "big" -> "bigger" */
+  else if (ends_with_cvc(word, len)) {
+    join_form(form, word, len, true, suffix);
+  } else {
+    join_form(form, word, len, false, suffix);
+  }
+
+  return true;
+}
+
+bool generate_er_form_into(const char *word, char *er_form, size_t size) {
+  return generate_degree_form(word, INFLECTION_ER, "er", er_form, size);
+}
+
+bool generate_est_form_into(const char *word, char *est_form, size_t size) {
+  return generate_degree_form(word, INFLECTION_EST, "est", est_form, size);
+}
+
+bool generate_inflection_into(const char *word, Inflection inflection,
+                              char *form, size_t size) {
+  switch (inflection) {
+  case INFLECTION_ED:
+    return generate_ed_form_into(word, form, size);
+  case INFLECTION_ING:
+    return generate_ing_form_into(word, form, size);
+  case INFLECTION_S:
+    return generate_s_form_into(word, form, size);
+  case INFLECTION_ER:
+    return generate_er_form_into(word, form, size);
+  case INFLECTION_EST:
+    return generate_est_form_into(word, form, size);
+  default:
+    return false;
+  }
+}
+
+/* Allocating wrappers; the caller frees the result */
+
+static char *generate_form(const char *verb,
+                           bool (*generate)(const char *, char *, size_t)) {
+  if (verb == NULL) {
+    return NULL;
+  }
+
+  size_t size = strlen(verb) + 8; /* Enough for doubling + suffix + null */
+  char *form = (char *)malloc(size);
+  if (form == NULL) {
+    return NULL;
+  }
+
+  if (!generate(verb, form, size)) {
+    free(form);
+    return NULL;
+  }
+  return form;
+}
+
+char *generate_ing_form(const char *verb) {
+  return generate_form(verb, generate_ing_form_into);
+}
+
+char *generate_ed_form(const char *verb) {
+  return generate_form(verb, generate_ed_form_into);
+}
@@ -0,0 +1,112 @@
+/**
+ * Node Table
+ * Dense id-to-node map behind the letter lists
+ *
+ * Letter lists hold 32-bit node ids instead of pointers, so that a list is
+ * one contiguous array that can be scanned and shifted cheaply. Every live
+ * node owns one slot here; ids of deleted nodes are recycled by the next
+ * insertions so the table stays dense. The word columns use the same ids.
+ */
+
+#include "../../include/english_words.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NODE_TABLE_INITIAL_CAPACITY 1024
+
+WordNode **g_node_table = NULL;
+
+static unsigned int g_table_capacity = 0;
+static unsigned int g_table_size = 0; /* Slots handed out so far */
+
+static unsigned int *g_free_ids = NULL;
+static unsigned int g_free_count = 0;
+static unsigned int g_free_capacity = 0;
+
+/* Table management */
+
+static bool grow_table(void) {
+  unsigned int new_capacity = g_table_capacity == 0
+                                  ? NODE_TABLE_INITIAL_CAPACITY
+                                  : g_table_capacity * 2;
+
+  WordNode **new_table = (WordNode **)realloc(
+      g_node_table, (size_t)new_capacity * sizeof(WordNode *));
+  if (new_table == NULL) {
+    fprintf(stderr, "Error: Unable to allocate memory for node table.\n");
+    return false;
+  }
+
+  g_node_table = new_table;
+  g_table_capacity = new_capacity;
+  return true;
+}
+
+/* Table operations */
+
+ErrorCode node_table_add(WordNode *node) {
+  if (node == NULL) {
+    return ERROR_INVALID_INPUT;
+  }
+
+  /* Reuse the id of a deleted node first */
+  if (g_free_count > 0) {
+    node->id = g_free_ids[g_free_count - 1];
+  } else if (g_table_size < g_table_capacity || grow_table()) {
+    node->id = g_table_size;
+  } else {
+    return ERROR_MEMORY_ALLOCATION;
+  }
+
+  /* The node's counts are mirrored in the slot of the same id */
+  if (!word_columns_set(node)) {
+    return ERROR_MEMORY_ALLOCATION;
+  }
+
+  if (g_free_count > 0) {
+    g_free_count--;
+  } else {
+    g_table_size++;
+  }
+  g_node_table[node->id] = node;
+  return SUCCESS;
+}
+
+void node_table_remove(const WordNode *node) {
+  if (node == NULL || node->id >= g_table_size ||
+      g_node_table[node->id] != node) {
+    return;
+  }
+
+  if (g_free_count == g_free_capacity) {
+    unsigned int new_capacity =
+        g_free_capacity == 0 ? NODE_TABLE_INITIAL_CAPACITY
+                             : g_free_capacity * 2;
+    unsigned int *new_ids = (unsigned int *)realloc(
+        g_free_ids, (size_t)new_capacity * sizeof(unsigned int));
+
+    /* Without room to recycle it, the slot simply stays unused */
+    if (new_ids == NULL) {
+      g_node_table[node->id] = NULL;
+      word_columns_remove(node->id);
+      return;
+    }
+    g_free_ids = new_ids;
+    g_free_capacity = new_capacity;
+  }
+
+  g_node_table[node->id] = NULL;
+  g_free_ids[g_free_count++] = node->id;
+  word_columns_remove(node->id);
+}
+
+void node_table_clear(void) {
+  free(g_node_table);
+  free(g_free_ids);
+  g_node_table = NULL;
+  g_free_ids = NULL;
+  g_table_capacity = 0;
+  g_table_size = 0;
+  g_free_count = 0;
+  g_free_capacity = 0;
+}
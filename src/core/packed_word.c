@@ -0,0 +1,123 @@
+/**
+ * Packed Words
+ * Words of up to PACKED_WORD_MAX_LETTERS letters packed 5 bits per letter
+ *
+ * Letters are stored case-folded (a = 1 ... z = 26, 0 past the end of the
+ * word) PACKED_LETTERS_PER_LANE to a 64-bit lane, with the case of each
+ * letter kept in a separate bitmask. Equality becomes a few integer
+ * compares and the Hamming distance of two words an XOR and a popcount per
+ * lane. Longer words are not packed and are compared as strings.
+ */
+
+#include "../../include/english_words.h"
+#include <string.h>
+
+/* Code of a masked letter in lexical patterns; never a letter's code */
+#define PACKED_WILDCARD 31u
+
+#define PACKED_LETTER_MASK ((1u << PACKED_LETTER_BITS) - 1)
+
+/* Lowest bit of every letter field in a lane */
+#define PACKED_FIELD_LOW_BITS UINT64_C(0x0084210842108421)
+
+/* Packing */
+
+bool pack_word(const char *word, PackedWord *packed) {
+  memset(packed, 0, sizeof(PackedWord));
+  if (word == NULL) {
+    return false;
+  }
+
+  size_t length = strlen(word);
+  if (length == 0 || length > PACKED_WORD_MAX_LETTERS) {
+    return false;
+  }
+
+  for (size_t i = 0; i < length; i++) {
+    /* Setting the case bit maps A-Z onto a-z */
+    unsigned int code = (unsigned int)(word[i] | 0x20) - 'a' + 1;
+    if (code == 0 || code > ALPHABET_SIZE) {
+      memset(packed, 0, sizeof(PackedWord));
+      return false;
+    }
+
+    size_t lane = i / PACKED_LETTERS_PER_LANE;
+    unsigned int shift =
+        (unsigned int)(i % PACKED_LETTERS_PER_LANE) * PACKED_LETTER_BITS;
+    packed->lanes[lane] |= (uint64_t)code << shift;
+    if ((word[i] & 0x20) == 0) {
+      packed->case_bits |= (uint64_t)1 << i;
+    }
+  }
+  return true;
+}
+
+bool packed_word_is_set(const PackedWord *packed) {
+  /* A packed word has at least one letter, whose code is never zero */
+  return packed->lanes[0] != 0;
+}
+
+void mask_packed_letter(const PackedWord *packed, int position,
+                        PackedWord *pattern) {
+  *pattern = *packed;
+
+  int lane = position / PACKED_LETTERS_PER_LANE;
+  unsigned int shift =
+      (unsigned int)(position % PACKED_LETTERS_PER_LANE) * PACKED_LETTER_BITS;
+  pattern->lanes[lane] |= (uint64_t)PACKED_WILDCARD << shift;
+  pattern->case_bits &= ~((uint64_t)1 << position);
+}
+
+unsigned int hash_packed_word(const PackedWord *packed) {
+  /* Multiply-xorshift mix, so that every key bit reaches the low bits */
+  uint64_t h = packed->case_bits;
+  for (int lane = 0; lane < PACKED_WORD_LANES; lane++) {
+    h = (h ^ packed->lanes[lane]) * UINT64_C(0x9E3779B97F4A7C15);
+    h ^= h >> 29;
+  }
+  return (unsigned int)(h ^ (h >> 32));
+}
+
+/* Comparison */
+
+bool packed_words_equal(const PackedWord *a, const PackedWord *b) {
+  uint64_t differences = a->case_bits ^ b->case_bits;
+  for (int lane = 0; lane < PACKED_WORD_LANES; lane++) {
+    differences |= a->lanes[lane] ^ b->lanes[lane];
+  }
+  return differences == 0;
+}
+
+/* Collapse each letter field of x to its lowest bit */
+static uint64_t fold_letter_fields(uint64_t x) {
+  return (x | (x >> 1) | (x >> 2) | (x >> 3) | (x >> 4)) &
+         PACKED_FIELD_LOW_BITS;
+}
+
+int packed_word_distance(const PackedWord *a, const PackedWord *b) {
+  int distance = 0;
+  for (int lane = 0; lane < PACKED_WORD_LANES; lane++) {
+    distance += count_bits(fold_letter_fields(a->lanes[lane] ^ b->lanes[lane]));
+  }
+
+  /* Letters differing in case only; rare enough to walk one by one */
+  for (uint64_t cases = a->case_bits ^ b->case_bits; cases != 0;
+       cases &= cases - 1) {
+    int position = lowest_bit(cases);
+    int lane = position / PACKED_LETTERS_PER_LANE;
+    unsigned int shift =
+        (unsigned int)(position % PACKED_LETTERS_PER_LANE) * PACKED_LETTER_BITS;
+    if ((((a->lanes[lane] ^ b->lanes[lane]) >> shift) & PACKED_LETTER_MASK) ==
+        0) {
+      distance++;
+    }
+  }
+  return distance;
+}
+
+bool same_word(const WordNode *a, const WordNode *b) {
+  if (packed_word_is_set(&a->packed) && packed_word_is_set(&b->packed)) {
+    return packed_words_equal(&a->packed, &b->packed);
+  }
+  return strcmp(a->clean_word, b->clean_word) == 0;
+}
@@ -2,6 +2,18 @@
  * Word Relationship Functions
  * Creating links between related words
  *
+ * A full build first registers every word in each relation's index, then
+ * searches each word's links. Both steps run on the thread pool: the five
+ * indexes are built side by side, and the link searches of all relations
+ * are split into chunks of words that the workers share. Searches only
+ * read the indexes; their results are applied on the calling thread in
+ * list order, so links and counts are those of a serial build.
+ *
+ * In lazy mode nothing is searched up front: a relation is linked for the
+ * whole dictionary by the first view listing it, and a single word's
+ * links are searched when its details are shown and cached until the
+ * next edit.
+ *
  * Improvements:
  * - Better null checking
  * - More efficient algorithms
@@ -9,6 +21,7 @@
  */
 
 #include "../../include/english_words.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -25,17 +38,11 @@ bool is_subword(const char *smaller, const char *larger) {
     return false;
   }
 
-  char *temp = (char *)malloc(smaller_len + 2);
-  if (temp == NULL) {
-    return false;
-  }
-
   int j = 0;
   int separations = 0;
 
   for (int i = 0; i < larger_len && j < smaller_len; i++) {
     if (larger[i] == smaller[j]) {
-      temp[j] = larger[i];
       j++;
 
       if (i < larger_len - 1 && j < smaller_len &&
@@ -50,14 +57,9 @@ bool is_subword(const char *smaller, const char *larger) {
     }
   }
 
-  temp[j] = '\0';
-
-  bool result =
-      (strcmp(temp, smaller) == 0 &&
-       (separations <= 1 || (separations <= 2 && larger[0] == smaller[0])));
-
-  free(temp);
-  return result;
+  /* Every matched character equals the next one of smaller */
+  return j == smaller_len &&
+         (separations <= 1 || (separations <= 2 && larger[0] == smaller[0]));
 }
 
 bool is_one_char_added(const char *smaller, const char *larger) {
@@ -77,6 +79,13 @@ bool are_lexically_close(const char *word1, const char *word2) {
     return false;
   }
 
+  /* Words that pack compare a lane of letters per XOR and popcount */
+  PackedWord packed1;
+  PackedWord packed2;
+  if (pack_word(word1, &packed1) && pack_word(word2, &packed2)) {
+    return packed_word_distance(&packed1, &packed2) == 1;
+  }
+
   int differences = 0;
   for (int i = 0; i < len1; i++) {
     if (word1[i] != word2[i]) {
@@ -90,193 +99,1382 @@ bool are_lexically_close(const char *word1, const char *word2) {
   return differences == 1;
 }
 
-/* Subword links */
+/* Link bookkeeping */
 
-int create_subword_links(void) {
-  int link_count = 0;
+/* Number of links currently set, per relation kind */
+static int g_link_counts[RELATION_COUNT];
+
+/*
+ * Relations whose lookup index has not been built yet, because their
+ * links were restored from a snapshot (inflections use the -ed bit for
+ * all their tables). Indexes are built on first use by an edit or a query.
+ */
+static unsigned int g_pending_indexes = 0;
+
+#define INDEX_BIT(kind) (1u << (kind))
+
+/* Every index; the inflection tables share the -ed bit */
+#define ALL_INDEX_BITS                                                        \
+  (INDEX_BIT(RELATION_SUBWORD) | INDEX_BIT(RELATION_ED_FORM) |                \
+   INDEX_BIT(RELATION_ADD_ONE_CHAR) | INDEX_BIT(RELATION_LEXICALLY_CLOSE) |   \
+   INDEX_BIT(RELATION_ANAGRAM))
+
+/*
+ * Relations whose links have not been searched yet in lazy mode. Their
+ * links are computed for the whole dictionary by the first view listing
+ * them, or word by word when a word's details are shown; a word's
+ * valid_links bits mark the deferred links already computed for it.
+ */
+static unsigned int g_deferred_links = 0;
+static bool g_lazy_links = false;
+
+/* Every kind has a bit in valid_links */
+typedef char valid_links_cover_every_kind
+    [RELATION_COUNT <= 8 * sizeof(unsigned short) ? 1 : -1];
+
+/* Ids of the words with valid_links bits set, cleared by the next edit */
+#define CHECKED_IDS_INITIAL_CAPACITY 64
+
+static unsigned int *g_checked_ids = NULL;
+static int g_checked_count = 0;
+static int g_checked_capacity = 0;
+
+static void build_pending_index(RelationKind kind);
+
+static bool links_deferred(RelationKind kind) {
+  return (g_deferred_links & INDEX_BIT(kind)) != 0;
+}
+
+static bool add_backlink(WordNode *target, const WordNode *source,
+                         RelationKind kind) {
+  if (target->backlink_count == target->backlink_capacity) {
+    int new_capacity =
+        target->backlink_capacity == 0 ? 2 : target->backlink_capacity * 2;
+    Backlink *new_backlinks =
+        (Backlink *)arena_alloc((size_t)new_capacity * sizeof(Backlink));
+    if (new_backlinks == NULL) {
+      fprintf(stderr, "Error: Unable to allocate memory for backlinks.\n");
+      return false;
+    }
+
+    /* Grow inside the arena; the old array goes back to its free list */
+    if (target->backlink_count > 0) {
+      memcpy(new_backlinks, target->backlinks,
+             (size_t)target->backlink_count * sizeof(Backlink));
+    }
+    arena_free(target->backlinks,
+               (size_t)target->backlink_capacity * sizeof(Backlink));
+    target->backlinks = new_backlinks;
+    target->backlink_capacity = new_capacity;
+  }
+
+  target->backlinks[target->backlink_count].source = source->id;
+  target->backlinks[target->backlink_count].kind = kind;
+  target->backlink_count++;
+  return true;
+}
+
+static void remove_backlink(WordNode *target, const WordNode *source,
+                            RelationKind kind) {
+  for (int i = 0; i < target->backlink_count; i++) {
+    if (target->backlinks[i].source == source->id &&
+        target->backlinks[i].kind == kind) {
+      target->backlinks[i] = target->backlinks[--target->backlink_count];
+      return;
+    }
+  }
+}
+
+/* Point a link of node at target, keeping backlinks and counts in step */
+static void set_link(WordNode *node, RelationKind kind, WordNode *target) {
+  unsigned int target_id = target != NULL ? target->id : NO_NODE_ID;
+  if (node->links[kind] == target_id) {
+    return;
+  }
+
+  if (node->links[kind] != NO_NODE_ID) {
+    remove_backlink(word_node_at(node->links[kind]), node, kind);
+    g_link_counts[kind]--;
+    node->links[kind] = NO_NODE_ID;
+  }
+
+  if (target != NULL && add_backlink(target, node, kind)) {
+    node->links[kind] = target_id;
+    g_link_counts[kind]++;
+  }
+}
 
+/* Whether node comes before the current kind link of source, if any */
+static bool precedes_link(const WordNode *node, const WordNode *source,
+                          RelationKind kind) {
+  const WordNode *current = linked_word(source, kind);
+  return current == NULL || compare_word_order(node, current) < 0;
+}
+
+/* Clear every link of one kind before a full rebuild */
+static void reset_relation(RelationKind kind) {
   for (int i = 0; i < ALPHABET_SIZE; i++) {
-    WordNode *current = g_word_lists[i].head;
+    const LetterList *list = &g_word_lists[i];
 
-    while (current != NULL) {
-      current->subword_of = NULL;
+    for (int pos = 0; pos < list->count; pos++) {
+      WordNode *current = word_node_at(list->ids[pos]);
+      current->links[kind] = NO_NODE_ID;
 
-      if (current->clean_word == NULL) {
-        current = current->next;
-        continue;
+      int kept = 0;
+      for (int k = 0; k < current->backlink_count; k++) {
+        if (current->backlinks[k].kind != kind) {
+          current->backlinks[kept++] = current->backlinks[k];
+        }
       }
+      current->backlink_count = kept;
+    }
+  }
 
-      for (int j = 0; j < ALPHABET_SIZE; j++) {
-        WordNode *candidate = g_word_lists[j].head;
+  g_link_counts[kind] = 0;
+}
 
-        while (candidate != NULL) {
-          if (candidate != current && candidate->clean_word != NULL &&
-              is_subword(current->clean_word, candidate->clean_word)) {
+/* Move the node just added to a bucket to its place in list order */
+static WordBucket *keep_list_order(WordBucket *bucket, WordNode *node) {
+  if (bucket == NULL) {
+    return NULL;
+  }
 
-            if (current->subword_of == NULL ||
-                strlen(candidate->clean_word) <
-                    strlen(current->subword_of->clean_word)) {
-              current->subword_of = candidate;
-            }
-          }
-          candidate = candidate->next;
-        }
+  int k = bucket->count - 1;
+  while (k > 0 && compare_word_order(bucket->nodes[k - 1], node) > 0) {
+    bucket->nodes[k] = bucket->nodes[k - 1];
+    k--;
+  }
+  bucket->nodes[k] = node;
+  return bucket;
+}
+
+/* Add node to the bucket for key, keeping the bucket in list order */
+static WordBucket *add_in_list_order(BucketTable *table, const char *key,
+                                     WordNode *node) {
+  return keep_list_order(bucket_table_add(table, key, node), node);
+}
+
+static WordBucket *add_packed_in_list_order(BucketTable *table,
+                                            const PackedWord *key,
+                                            WordNode *node) {
+  return keep_list_order(bucket_table_add_packed(table, key, node), node);
+}
+
+void update_link_statistics(Statistics *stats) {
+  if (stats == NULL) {
+    return;
+  }
+
+  stats->subword_links = g_link_counts[RELATION_SUBWORD];
+  stats->verb_form_links =
+      g_link_counts[RELATION_ED_FORM] + g_link_counts[RELATION_ING_FORM];
+  stats->inflection_links = g_link_counts[RELATION_S_FORM] +
+                            g_link_counts[RELATION_ER_FORM] +
+                            g_link_counts[RELATION_EST_FORM];
+  stats->add_one_char_links = g_link_counts[RELATION_ADD_ONE_CHAR];
+  stats->lexclose_links = g_link_counts[RELATION_LEXICALLY_CLOSE];
+  stats->anagram_links = g_link_counts[RELATION_ANAGRAM];
+}
+
+/* Parallel construction */
+
+#define LINK_SEARCH_GRAIN 64 /* Words per chunk of a link search */
+
+/* Words to link, in list order */
+typedef struct {
+  WordNode **nodes;
+  size_t count;
+  bool failed; /* An index could not be built */
+} WordSet;
+
+/* Best target of one kind of link from node, or NULL */
+typedef WordNode *(*LinkFinder)(const WordNode *node);
+
+typedef struct {
+  RelationKind kind;
+  LinkFinder find;
+  const WordSet *words;
+  WordNode **targets; /* Found target per word */
+} LinkSearch;
+
+static bool collect_words(WordSet *words) {
+  words->nodes = NULL;
+  words->count = 0;
+  words->failed = false;
+
+  size_t total = 0;
+  for (int i = 0; i < ALPHABET_SIZE; i++) {
+    total += (size_t)g_word_lists[i].count;
+  }
+  if (total == 0) {
+    return true;
+  }
+
+  words->nodes = (WordNode **)malloc(total * sizeof(WordNode *));
+  if (words->nodes == NULL) {
+    fprintf(stderr, "Error: Unable to allocate memory for relationships.\n");
+    return false;
+  }
+
+  for (int i = 0; i < ALPHABET_SIZE; i++) {
+    const LetterList *list = &g_word_lists[i];
+
+    for (int pos = 0; pos < list->count; pos++) {
+      WordNode *current = word_node_at(list->ids[pos]);
+      if (current->clean_word != NULL) {
+        words->nodes[words->count++] = current;
       }
+    }
+  }
+  return true;
+}
 
-      if (current->subword_of != NULL) {
-        link_count++;
+static void run_link_search(void *context, size_t begin, size_t end) {
+  LinkSearch *search = (LinkSearch *)context;
+  for (size_t i = begin; i < end; i++) {
+    search->targets[i] = search->find(search->words->nodes[i]);
+  }
+}
+
+/* Search every word's links of each kind, then set them in list order */
+static void search_links(LinkSearch *searches, int search_count,
+                         const WordSet *words) {
+  ParallelLoop loops[RELATION_COUNT];
+  bool allocated = true;
+
+  for (int s = 0; s < search_count; s++) {
+    searches[s].words = words;
+    searches[s].targets = (WordNode **)malloc(
+        (words->count > 0 ? words->count : 1) * sizeof(WordNode *));
+    allocated &= searches[s].targets != NULL;
+
+    loops[s].body = run_link_search;
+    loops[s].context = &searches[s];
+    loops[s].count = words->count;
+    loops[s].grain = LINK_SEARCH_GRAIN;
+  }
+
+  if (allocated) {
+    run_parallel_loops(loops, search_count);
+
+    for (int s = 0; s < search_count; s++) {
+      for (size_t i = 0; i < words->count; i++) {
+        set_link(words->nodes[i], searches[s].kind, searches[s].targets[i]);
       }
+    }
+  } else {
+    fprintf(stderr, "Error: Unable to allocate memory for relationships.\n");
+  }
+
+  for (int s = 0; s < search_count; s++) {
+    free(searches[s].targets);
+  }
+}
+
+/* Subword links */
 
-      current = current->next;
+/* Words grouped by clean length, each group kept in list order */
+typedef struct {
+  WordNode **nodes;
+  unsigned int *letter_masks; /* Copy of each node's mask, scanned densely */
+  int count;
+  int capacity;
+} LengthGroup;
+
+static LengthGroup g_length_groups[MAX_WORD_LENGTH];
+
+static bool add_to_length_group(WordNode *node) {
+  size_t len = strlen(node->clean_word);
+  if (len >= MAX_WORD_LENGTH) {
+    return true;
+  }
+
+  LengthGroup *group = &g_length_groups[len];
+  if (group->count == group->capacity) {
+    int new_capacity = group->capacity == 0 ? 16 : group->capacity * 2;
+    WordNode **new_nodes = (WordNode **)realloc(
+        group->nodes, (size_t)new_capacity * sizeof(WordNode *));
+    if (new_nodes == NULL) {
+      return false;
     }
+    group->nodes = new_nodes;
+
+    unsigned int *new_masks = (unsigned int *)realloc(
+        group->letter_masks, (size_t)new_capacity * sizeof(unsigned int));
+    if (new_masks == NULL) {
+      return false;
+    }
+    group->letter_masks = new_masks;
+    group->capacity = new_capacity;
   }
 
-  return link_count;
+  /* Shift later words right so the group stays in list order */
+  int k = group->count;
+  while (k > 0 && compare_word_order(group->nodes[k - 1], node) > 0) {
+    group->nodes[k] = group->nodes[k - 1];
+    group->letter_masks[k] = group->letter_masks[k - 1];
+    k--;
+  }
+
+  group->nodes[k] = node;
+  group->letter_masks[k] = node->letter_mask;
+  group->count++;
+  return true;
 }
 
-/* Verb form links */
+static void remove_from_length_group(const WordNode *node) {
+  size_t len = strlen(node->clean_word);
+  if (len >= MAX_WORD_LENGTH) {
+    return;
+  }
 
-int create_verb_form_links(void) {
-  int link_count = 0;
+  LengthGroup *group = &g_length_groups[len];
+  for (int k = 0; k < group->count; k++) {
+    if (group->nodes[k] == node) {
+      size_t tail = (size_t)(group->count - k - 1);
+      memmove(&group->nodes[k], &group->nodes[k + 1],
+              tail * sizeof(WordNode *));
+      memmove(&group->letter_masks[k], &group->letter_masks[k + 1],
+              tail * sizeof(unsigned int));
+      group->count--;
+      return;
+    }
+  }
+}
 
-  for (int i = 0; i < ALPHABET_SIZE; i++) {
-    WordNode *current = g_word_lists[i].head;
+static void clear_length_groups(void) {
+  for (int len = 0; len < MAX_WORD_LENGTH; len++) {
+    free(g_length_groups[len].nodes);
+    free(g_length_groups[len].letter_masks);
+    g_length_groups[len].nodes = NULL;
+    g_length_groups[len].letter_masks = NULL;
+    g_length_groups[len].count = 0;
+    g_length_groups[len].capacity = 0;
+  }
+}
+
+/* Necessary condition once the masks match: no letter occurs more often */
+static bool letter_counts_fit(const WordNode *smaller,
+                              const WordNode *larger) {
+  unsigned int mask = smaller->letter_mask;
+  for (int c = 0; mask != 0; c++, mask >>= 1) {
+    if ((mask & 1u) && smaller->letter_counts[c] > larger->letter_counts[c]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * Visiting longer groups in increasing length, each in list order, the
+ * first match is the shortest superword found first by a full scan.
+ */
+static WordNode *find_subword_of(const WordNode *node) {
+  size_t len = strlen(node->clean_word);
+  unsigned int mask = node->letter_mask;
 
-    while (current != NULL) {
-      current->ing_form = NULL;
-      current->ed_form = NULL;
+  for (size_t longer = len + 1; longer < MAX_WORD_LENGTH; longer++) {
+    const LengthGroup *candidates = &g_length_groups[longer];
 
-      if (current->clean_word == NULL) {
-        current = current->next;
+    for (int c = 0; c < candidates->count; c++) {
+      /* Reject on the dense mask column before touching the node */
+      if ((candidates->letter_masks[c] & mask) != mask) {
         continue;
       }
 
-      /* Check for -ing form */
-      char *ing = generate_ing_form(current->clean_word);
-      if (ing != NULL) {
-        /* Search in all lists */
-        for (int k = 0; k < ALPHABET_SIZE; k++) {
-          WordNode *ing_node = search_word(g_word_lists[k].head, ing);
-          if (ing_node != NULL && ing_node != current) {
-            current->ing_form = ing_node;
-            link_count++;
-            break;
-          }
-        }
-        free(ing);
+      WordNode *candidate = candidates->nodes[c];
+      if (letter_counts_fit(node, candidate) &&
+          is_subword(node->clean_word, candidate->clean_word)) {
+        return candidate;
       }
+    }
+  }
 
-      /* Check for -ed form */
-      char *ed = generate_ed_form(current->clean_word);
-      if (ed != NULL) {
-        /* Search in all lists */
-        for (int k = 0; k < ALPHABET_SIZE; k++) {
-          WordNode *ed_node = search_word(g_word_lists[k].head, ed);
-          if (ed_node != NULL && ed_node != current) {
-            current->ed_form = ed_node;
-            link_count++;
-            break;
-          }
-        }
-        free(ed);
+  return NULL;
+}
+
+/* Make candidate the superword of the word spelled text if it is better */
+static void offer_superword(const char *text, WordNode *candidate) {
+  WordNode *smaller = search_word(text);
+  if (smaller == NULL || smaller == candidate ||
+      !is_subword(smaller->clean_word, candidate->clean_word)) {
+    return;
+  }
+
+  const WordNode *current = linked_word(smaller, RELATION_SUBWORD);
+  if (current != NULL) {
+    size_t candidate_len = strlen(candidate->clean_word);
+    size_t current_len = strlen(current->clean_word);
+    if (candidate_len > current_len ||
+        (candidate_len == current_len &&
+         compare_word_order(candidate, current) > 0)) {
+      return;
+    }
+  }
+
+  set_link(smaller, RELATION_SUBWORD, candidate);
+}
+
+/*
+ * is_subword only accepts a contiguous substring of the larger word, or a
+ * prefix followed by a later substring, so those are the only words whose
+ * link can move to a newly inserted word.
+ */
+static void link_subwords_of(WordNode *node) {
+  const char *word = node->clean_word;
+  size_t len = strlen(word);
+  char text[MAX_WORD_LENGTH];
+
+  for (size_t start = 0; start < len; start++) {
+    for (size_t end = start + 1; end <= len; end++) {
+      if (end - start == len) {
+        continue;
+      }
+      memcpy(text, word + start, end - start);
+      text[end - start] = '\0';
+      offer_superword(text, node);
+    }
+  }
+
+  for (size_t prefix = 1; prefix < len; prefix++) {
+    for (size_t start = prefix + 1; start < len; start++) {
+      for (size_t end = start + 1; end <= len; end++) {
+        memcpy(text, word, prefix);
+        memcpy(text + prefix, word + start, end - start);
+        text[prefix + end - start] = '\0';
+        offer_superword(text, node);
       }
+    }
+  }
+}
 
-      current = current->next;
+static void index_subwords(void *context, size_t begin, size_t end) {
+  WordSet *words = (WordSet *)context;
+  for (size_t i = begin; i < end; i++) {
+    if (!add_to_length_group(words->nodes[i])) {
+      fprintf(stderr, "Error: Unable to allocate memory for subwords.\n");
+      clear_length_groups();
+      words->failed = true;
+      return;
     }
   }
+}
+
+int create_subword_links(void) {
+  reset_relation(RELATION_SUBWORD);
+  clear_length_groups();
+  g_pending_indexes &= ~INDEX_BIT(RELATION_SUBWORD);
+  g_deferred_links &= ~INDEX_BIT(RELATION_SUBWORD);
+
+  WordSet words;
+  if (!collect_words(&words)) {
+    return 0;
+  }
+
+  index_subwords(&words, 0, words.count);
+  if (!words.failed) {
+    LinkSearch search = {RELATION_SUBWORD, find_subword_of, NULL, NULL};
+    search_links(&search, 1, &words);
+  }
+
+  free(words.nodes);
+  return g_link_counts[RELATION_SUBWORD];
+}
+
+/* Inflection links */
+
+/*
+ * Each inflected form of a word is generated once into a stack buffer and
+ * resolved with one probe of the word index, so a full pass is linear in
+ * the number of words. The reverse tables map every generated form to the
+ * words generating it, which lets an inserted word find the words that
+ * inflect to it with one probe per inflection.
+ */
+static BucketTable g_inflection_bases[INFLECTION_COUNT];
+
+static void register_inflections(WordNode *node) {
+  char form[INFLECTION_BUFFER_SIZE];
+
+  for (int i = 0; i < INFLECTION_COUNT; i++) {
+    if (generate_inflection_into(node->clean_word, (Inflection)i, form,
+                                 sizeof(form))) {
+      bucket_table_add(&g_inflection_bases[i], form, node);
+    }
+  }
+}
+
+static void link_inflections(WordNode *node) {
+  char form[INFLECTION_BUFFER_SIZE];
+
+  for (int i = 0; i < INFLECTION_COUNT; i++) {
+    if (generate_inflection_into(node->clean_word, (Inflection)i, form,
+                                 sizeof(form))) {
+      bucket_table_add(&g_inflection_bases[i], form, node);
+
+      /* Single probe of the word index */
+      WordNode *found = search_word(form);
+      set_link(node, inflection_relation((Inflection)i),
+               found != node ? found : NULL);
+    }
+  }
+}
 
-  return link_count;
+/* Word spelled as the given inflection of node, other than node */
+static WordNode *find_inflection(const WordNode *node,
+                                 Inflection inflection) {
+  char form[INFLECTION_BUFFER_SIZE];
+  if (!generate_inflection_into(node->clean_word, inflection, form,
+                                sizeof(form))) {
+    return NULL;
+  }
+
+  WordNode *found = search_word(form);
+  return found != node ? found : NULL;
+}
+
+static WordNode *find_ed_form(const WordNode *node) {
+  return find_inflection(node, INFLECTION_ED);
+}
+
+static WordNode *find_ing_form(const WordNode *node) {
+  return find_inflection(node, INFLECTION_ING);
+}
+
+static WordNode *find_s_form(const WordNode *node) {
+  return find_inflection(node, INFLECTION_S);
+}
+
+static WordNode *find_er_form(const WordNode *node) {
+  return find_inflection(node, INFLECTION_ER);
+}
+
+static WordNode *find_est_form(const WordNode *node) {
+  return find_inflection(node, INFLECTION_EST);
+}
+
+static void unregister_inflections(const WordNode *node) {
+  char form[INFLECTION_BUFFER_SIZE];
+
+  for (int i = 0; i < INFLECTION_COUNT; i++) {
+    if (generate_inflection_into(node->clean_word, (Inflection)i, form,
+                                 sizeof(form))) {
+      bucket_table_remove(&g_inflection_bases[i], form, node);
+    }
+  }
+}
+
+/* Link every word whose generated form is the newly inserted node */
+static void link_inflection_bases(WordNode *node) {
+  for (int i = 0; i < INFLECTION_COUNT; i++) {
+    const WordBucket *bucket =
+        bucket_table_find(&g_inflection_bases[i], node->clean_word);
+    for (int k = 0; bucket != NULL && k < bucket->count; k++) {
+      if (bucket->nodes[k] != node) {
+        set_link(bucket->nodes[k], inflection_relation((Inflection)i), node);
+      }
+    }
+  }
+}
+
+static void index_inflections(void *context, size_t begin, size_t end) {
+  const WordSet *words = (const WordSet *)context;
+  for (size_t i = begin; i < end; i++) {
+    register_inflections(words->nodes[i]);
+  }
+}
+
+static void clear_inflection_bases(void) {
+  for (int i = 0; i < INFLECTION_COUNT; i++) {
+    bucket_table_clear(&g_inflection_bases[i]);
+  }
+}
+
+/* Searches for every inflection link, in Inflection order */
+#define INFLECTION_SEARCHES                                                   \
+  {RELATION_ED_FORM, find_ed_form, NULL, NULL},                               \
+      {RELATION_ING_FORM, find_ing_form, NULL, NULL},                         \
+      {RELATION_S_FORM, find_s_form, NULL, NULL},                             \
+      {RELATION_ER_FORM, find_er_form, NULL, NULL},                           \
+      {RELATION_EST_FORM, find_est_form, NULL, NULL}
+
+int create_inflection_links(void) {
+  int total = 0;
+  for (int i = 0; i < INFLECTION_COUNT; i++) {
+    reset_relation(inflection_relation((Inflection)i));
+    g_deferred_links &= ~INDEX_BIT(inflection_relation((Inflection)i));
+  }
+  clear_inflection_bases();
+  g_pending_indexes &= ~INDEX_BIT(RELATION_ED_FORM);
+
+  WordSet words;
+  if (!collect_words(&words)) {
+    return 0;
+  }
+
+  index_inflections(&words, 0, words.count);
+  LinkSearch searches[] = {INFLECTION_SEARCHES};
+  search_links(searches, INFLECTION_COUNT, &words);
+
+  free(words.nodes);
+  for (int i = 0; i < INFLECTION_COUNT; i++) {
+    total += g_link_counts[inflection_relation((Inflection)i)];
+  }
+  return total;
+}
+
+/* Add-one-character links */
+
+/*
+ * Each word is registered under every string obtained by deleting one of
+ * its characters, so the words formed by adding one character to X are
+ * the members of the bucket keyed on X itself.
+ */
+static BucketTable g_deletion_patterns;
+
+static void update_deletion_patterns(WordNode *node, bool registering) {
+  const char *word = node->clean_word;
+  size_t len = strlen(word);
+  char pattern[MAX_WORD_LENGTH];
+
+  for (size_t p = 0; p < len; p++) {
+    /* Deleting any letter of a run gives the same string */
+    if (p > 0 && word[p] == word[p - 1]) {
+      continue;
+    }
+    memcpy(pattern, word, p);
+    strcpy(pattern + p, word + p + 1);
+
+    if (registering) {
+      add_in_list_order(&g_deletion_patterns, pattern, node);
+    } else {
+      bucket_table_remove(&g_deletion_patterns, pattern, node);
+    }
+  }
+}
+
+/* First longer word, in list order, formed by adding one character */
+static WordNode *find_add_one_char(const WordNode *node) {
+  const WordBucket *bucket =
+      bucket_table_find(&g_deletion_patterns, node->clean_word);
+
+  for (int k = 0; bucket != NULL && k < bucket->count; k++) {
+    if (is_one_char_added(node->clean_word, bucket->nodes[k]->clean_word)) {
+      return bucket->nodes[k];
+    }
+  }
+  return NULL;
+}
+
+/* Link the words that the newly inserted node extends by one character */
+static void link_one_char_bases(WordNode *node) {
+  const char *word = node->clean_word;
+  size_t len = strlen(word);
+  char pattern[MAX_WORD_LENGTH];
+
+  for (size_t p = 0; p < len; p++) {
+    if (p > 0 && word[p] == word[p - 1]) {
+      continue;
+    }
+    memcpy(pattern, word, p);
+    strcpy(pattern + p, word + p + 1);
+
+    WordNode *smaller = search_word(pattern);
+    if (smaller != NULL && smaller != node &&
+        is_one_char_added(smaller->clean_word, word) &&
+        precedes_link(node, smaller, RELATION_ADD_ONE_CHAR)) {
+      set_link(smaller, RELATION_ADD_ONE_CHAR, node);
+    }
+  }
+}
+
+/* Register every word under each of its single-character deletions */
+static void index_deletion_patterns(void *context, size_t begin,
+                                    size_t end) {
+  const WordSet *words = (const WordSet *)context;
+  for (size_t i = begin; i < end; i++) {
+    update_deletion_patterns(words->nodes[i], true);
+  }
+}
+
+int create_add_one_char_links(void) {
+  reset_relation(RELATION_ADD_ONE_CHAR);
+  bucket_table_clear(&g_deletion_patterns);
+  g_pending_indexes &= ~INDEX_BIT(RELATION_ADD_ONE_CHAR);
+  g_deferred_links &= ~INDEX_BIT(RELATION_ADD_ONE_CHAR);
+
+  WordSet words;
+  if (!collect_words(&words)) {
+    return 0;
+  }
+
+  /* Link each word to the first longer word that contains it */
+  index_deletion_patterns(&words, 0, words.count);
+  LinkSearch search = {RELATION_ADD_ONE_CHAR, find_add_one_char, NULL, NULL};
+  search_links(&search, 1, &words);
+
+  free(words.nodes);
+  return g_link_counts[RELATION_ADD_ONE_CHAR];
 }
 
 /* Lexically close links */
 
-int create_lexically_close_links(void) {
-  int link_count = 0;
+/*
+ * Each word of length L is registered under its L masked patterns
+ * ("c?t", "?at", ...), so its Hamming-distance-1 neighbours are exactly
+ * the other members of those L buckets. Packed words use packed patterns,
+ * where the masked letter gets a code no letter has; longer words keep
+ * string patterns. Neighbours have equal lengths, so the two never mix.
+ */
+static BucketTable g_lexical_patterns;
 
-  for (int i = 0; i < ALPHABET_SIZE; i++) {
-    WordNode *current = g_word_lists[i].head;
+static void make_lexical_pattern(const char *word, size_t position,
+                                 char *pattern) {
+  strcpy(pattern, word);
+  pattern[position] = '?';
+}
+
+/* Bucket of the word's pattern masked at position, if any */
+static WordBucket *find_lexical_bucket(const char *word,
+                                       const PackedWord *packed,
+                                       size_t position) {
+  if (packed_word_is_set(packed)) {
+    PackedWord pattern;
+    mask_packed_letter(packed, (int)position, &pattern);
+    return bucket_table_find_packed(&g_lexical_patterns, &pattern);
+  }
+
+  char pattern[MAX_WORD_LENGTH];
+  make_lexical_pattern(word, position, pattern);
+  return bucket_table_find(&g_lexical_patterns, pattern);
+}
+
+static void update_lexical_patterns(WordNode *node, bool registering) {
+  size_t len = strlen(node->clean_word);
+
+  if (packed_word_is_set(&node->packed)) {
+    PackedWord pattern;
+    for (size_t p = 0; p < len; p++) {
+      mask_packed_letter(&node->packed, (int)p, &pattern);
+      if (registering) {
+        add_packed_in_list_order(&g_lexical_patterns, &pattern, node);
+      } else {
+        bucket_table_remove_packed(&g_lexical_patterns, &pattern, node);
+      }
+    }
+    return;
+  }
+
+  char pattern[MAX_WORD_LENGTH];
+  for (size_t p = 0; p < len; p++) {
+    make_lexical_pattern(node->clean_word, p, pattern);
+    if (registering) {
+      add_in_list_order(&g_lexical_patterns, pattern, node);
+    } else {
+      bucket_table_remove(&g_lexical_patterns, pattern, node);
+    }
+  }
+}
 
-    while (current != NULL) {
-      current->lexically_close = NULL;
-      bool found_self = false;
+int find_lexically_close_words(const char *word, WordNode **results,
+                               int max_results) {
+  if (word == NULL) {
+    return 0;
+  }
+
+  size_t len = strlen(word);
+  if (len == 0 || len >= MAX_WORD_LENGTH) {
+    return 0;
+  }
+
+  PackedWord packed;
+  bool is_packed = pack_word(word, &packed);
+  int found = 0;
+
+  build_pending_index(RELATION_LEXICALLY_CLOSE);
+
+  for (size_t p = 0; p < len; p++) {
+    const WordBucket *bucket = find_lexical_bucket(word, &packed, p);
+    if (bucket == NULL) {
+      continue;
+    }
 
-      if (current->clean_word == NULL) {
-        current = current->next;
+    for (int k = 0; k < bucket->count; k++) {
+      /* Skip the word itself; every other member differs at p only */
+      const WordNode *member = bucket->nodes[k];
+      if (is_packed ? packed_words_equal(&member->packed, &packed)
+                    : strcmp(member->clean_word, word) == 0) {
         continue;
       }
+      if (found < max_results) {
+        results[found] = bucket->nodes[k];
+      }
+      found++;
+    }
+  }
 
-      for (int j = 0; j < ALPHABET_SIZE; j++) {
-        WordNode *candidate = g_word_lists[j].head;
-
-        while (candidate != NULL) {
-          if (candidate == current) {
-            found_self = true;
-          } else if (found_self && candidate->clean_word != NULL &&
-                     are_lexically_close(current->clean_word,
-                                         candidate->clean_word)) {
-            current->lexically_close = candidate;
-            link_count++;
-            break;
-          }
-          candidate = candidate->next;
-        }
+  return found;
+}
+
+/* First neighbour that comes after node in list order */
+static WordNode *find_lexically_close(const WordNode *node) {
+  size_t len = strlen(node->clean_word);
+  WordNode *best = NULL;
+
+  for (size_t p = 0; p < len; p++) {
+    const WordBucket *bucket =
+        find_lexical_bucket(node->clean_word, &node->packed, p);
 
-        if (current->lexically_close != NULL) {
-          break;
+    /* Buckets are in list order: the first later member is the best here */
+    for (int k = 0; bucket != NULL && k < bucket->count; k++) {
+      WordNode *candidate = bucket->nodes[k];
+      if (compare_word_order(candidate, node) > 0 &&
+          !same_word(candidate, node)) {
+        if (best == NULL || compare_word_order(candidate, best) < 0) {
+          best = candidate;
         }
+        break;
       }
+    }
+  }
+
+  return best;
+}
+
+/* Earlier neighbours switch to the new node if it precedes their link */
+static void link_earlier_neighbours(WordNode *node) {
+  size_t len = strlen(node->clean_word);
+
+  for (size_t p = 0; p < len; p++) {
+    const WordBucket *bucket =
+        find_lexical_bucket(node->clean_word, &node->packed, p);
 
-      current = current->next;
+    for (int k = 0; bucket != NULL && k < bucket->count; k++) {
+      WordNode *neighbour = bucket->nodes[k];
+      if (neighbour == node) {
+        break;
+      }
+      if (!same_word(neighbour, node) &&
+          precedes_link(node, neighbour, RELATION_LEXICALLY_CLOSE)) {
+        set_link(neighbour, RELATION_LEXICALLY_CLOSE, node);
+      }
     }
   }
+}
+
+/* Register every word under each of its masked patterns */
+static void index_lexical_patterns(void *context, size_t begin, size_t end) {
+  const WordSet *words = (const WordSet *)context;
+  for (size_t i = begin; i < end; i++) {
+    update_lexical_patterns(words->nodes[i], true);
+  }
+}
+
+int create_lexically_close_links(void) {
+  reset_relation(RELATION_LEXICALLY_CLOSE);
+  bucket_table_clear(&g_lexical_patterns);
+  g_pending_indexes &= ~INDEX_BIT(RELATION_LEXICALLY_CLOSE);
+  g_deferred_links &= ~INDEX_BIT(RELATION_LEXICALLY_CLOSE);
+
+  WordSet words;
+  if (!collect_words(&words)) {
+    return 0;
+  }
+
+  index_lexical_patterns(&words, 0, words.count);
+  LinkSearch search = {RELATION_LEXICALLY_CLOSE, find_lexically_close, NULL,
+                       NULL};
+  search_links(&search, 1, &words);
 
-  return link_count;
+  free(words.nodes);
+  return g_link_counts[RELATION_LEXICALLY_CLOSE];
 }
 
 /* Anagram links */
 
+/* Anagram classes keyed on the alphabetically sorted signature */
+static BucketTable g_anagram_classes;
+
+/* Signatures that fit are keyed packed, like the lexical patterns */
+static WordBucket *add_to_anagram_class(WordNode *node) {
+  char sorted[MAX_WORD_LENGTH];
+  format_sorted_word(node, sorted);
+
+  PackedWord signature;
+  if (pack_word(sorted, &signature)) {
+    return add_packed_in_list_order(&g_anagram_classes, &signature, node);
+  }
+  return add_in_list_order(&g_anagram_classes, sorted, node);
+}
+
+static void remove_from_anagram_class(WordNode *node) {
+  char sorted[MAX_WORD_LENGTH];
+  format_sorted_word(node, sorted);
+
+  PackedWord signature;
+  if (pack_word(sorted, &signature)) {
+    bucket_table_remove_packed(&g_anagram_classes, &signature, node);
+  } else {
+    bucket_table_remove(&g_anagram_classes, sorted, node);
+  }
+  node->anagram_class = NULL;
+}
+
+/* Next member of the node's class in list order */
+static WordNode *find_next_anagram(const WordNode *node) {
+  const WordBucket *class = node->anagram_class;
+  if (class == NULL) {
+    return NULL;
+  }
+
+  for (int k = 0; k + 1 < class->count; k++) {
+    if (class->nodes[k] == node) {
+      return class->nodes[k + 1];
+    }
+  }
+  return NULL;
+}
+
+/* Group every word by its signature in a single pass */
+static void index_anagram_classes(void *context, size_t begin, size_t end) {
+  const WordSet *words = (const WordSet *)context;
+  for (size_t i = begin; i < end; i++) {
+    words->nodes[i]->anagram_class = add_to_anagram_class(words->nodes[i]);
+  }
+}
+
 int create_anagram_links(void) {
-  int link_count = 0;
+  reset_relation(RELATION_ANAGRAM);
+  bucket_table_clear(&g_anagram_classes);
+  g_pending_indexes &= ~INDEX_BIT(RELATION_ANAGRAM);
+  g_deferred_links &= ~INDEX_BIT(RELATION_ANAGRAM);
+
+  WordSet words;
+  if (!collect_words(&words)) {
+    return 0;
+  }
+
+  /* Chain each member of a class to the next one */
+  index_anagram_classes(&words, 0, words.count);
+  LinkSearch search = {RELATION_ANAGRAM, find_next_anagram, NULL, NULL};
+  search_links(&search, 1, &words);
+
+  free(words.nodes);
+  return g_link_counts[RELATION_ANAGRAM];
+}
+
+/* Full rebuild */
+
+/* Every relation at once: indexes side by side, then all link searches */
+void rebuild_relationships(void) {
+  for (int kind = 0; kind < RELATION_COUNT; kind++) {
+    reset_relation((RelationKind)kind);
+  }
+  free_relationship_indexes();
+
+  WordSet words;
+  if (!collect_words(&words)) {
+    return;
+  }
+
+  /* Each index is built by one task, in list order */
+  ParallelLoop indexes[] = {
+      {index_subwords, &words, words.count, words.count},
+      {index_inflections, &words, words.count, words.count},
+      {index_deletion_patterns, &words, words.count, words.count},
+      {index_lexical_patterns, &words, words.count, words.count},
+      {index_anagram_classes, &words, words.count, words.count},
+  };
+  run_parallel_loops(indexes, (int)(sizeof(indexes) / sizeof(indexes[0])));
+
+  LinkSearch searches[RELATION_COUNT] = {
+      {RELATION_SUBWORD, find_subword_of, NULL, NULL},
+      INFLECTION_SEARCHES,
+      {RELATION_ADD_ONE_CHAR, find_add_one_char, NULL, NULL},
+      {RELATION_LEXICALLY_CLOSE, find_lexically_close, NULL, NULL},
+      {RELATION_ANAGRAM, find_next_anagram, NULL, NULL},
+  };
+
+  /* Without its index, the subword search is left out */
+  if (words.failed) {
+    search_links(searches + 1, RELATION_COUNT - 1, &words);
+  } else {
+    search_links(searches, RELATION_COUNT, &words);
+  }
+
+  free(words.nodes);
+}
+
+/* Lazy relationships */
+
+/* Best target of each kind, for the deferred links of a single word */
+static const LinkFinder g_link_finders[RELATION_COUNT] = {
+    [RELATION_SUBWORD] = find_subword_of,
+    [RELATION_ED_FORM] = find_ed_form,
+    [RELATION_ING_FORM] = find_ing_form,
+    [RELATION_S_FORM] = find_s_form,
+    [RELATION_ER_FORM] = find_er_form,
+    [RELATION_EST_FORM] = find_est_form,
+    [RELATION_ADD_ONE_CHAR] = find_add_one_char,
+    [RELATION_LEXICALLY_CLOSE] = find_lexically_close,
+    [RELATION_ANAGRAM] = find_next_anagram,
+};
+
+static bool remember_checked_word(const WordNode *node) {
+  if (g_checked_count == g_checked_capacity) {
+    int new_capacity = g_checked_capacity == 0 ? CHECKED_IDS_INITIAL_CAPACITY
+                                               : g_checked_capacity * 2;
+    unsigned int *new_ids = (unsigned int *)realloc(
+        g_checked_ids, (size_t)new_capacity * sizeof(unsigned int));
+    if (new_ids == NULL) {
+      return false;
+    }
+    g_checked_ids = new_ids;
+    g_checked_capacity = new_capacity;
+  }
+
+  g_checked_ids[g_checked_count++] = node->id;
+  return true;
+}
+
+/* Any word's links may change with an edit, so all are computed again */
+static void invalidate_word_links(void) {
+  for (int i = 0; i < g_checked_count; i++) {
+    WordNode *node = word_node_at(g_checked_ids[i]);
+    if (node != NULL) {
+      node->valid_links = 0;
+    }
+  }
+  g_checked_count = 0;
+}
+
+/* Drop every link and index; each is built again on first use */
+void defer_relationships(void) {
+  for (int kind = 0; kind < RELATION_COUNT; kind++) {
+    reset_relation((RelationKind)kind);
+  }
+  free_relationship_indexes();
 
   for (int i = 0; i < ALPHABET_SIZE; i++) {
-    WordNode *current = g_word_lists[i].head;
+    const LetterList *list = &g_word_lists[i];
+    for (int pos = 0; pos < list->count; pos++) {
+      word_node_at(list->ids[pos])->valid_links = 0;
+    }
+  }
+
+  g_pending_indexes = ALL_INDEX_BITS;
+  g_deferred_links = INDEX_BIT(RELATION_COUNT) - 1;
+  g_lazy_links = true;
+}
+
+/* Replace every link after a bulk edit, eagerly or lazily as before */
+void refresh_relationships(void) {
+  if (g_lazy_links) {
+    defer_relationships();
+  } else {
+    rebuild_relationships();
+  }
+}
+
+bool relationships_deferred(void) { return g_deferred_links != 0; }
+
+/* Links of one kind for the whole dictionary; inflections come together */
+void ensure_relation_links(RelationKind kind) {
+  if (!links_deferred(kind)) {
+    return;
+  }
+
+  switch (kind) {
+  case RELATION_SUBWORD:
+    create_subword_links();
+    break;
+  case RELATION_ADD_ONE_CHAR:
+    create_add_one_char_links();
+    break;
+  case RELATION_LEXICALLY_CLOSE:
+    create_lexically_close_links();
+    break;
+  case RELATION_ANAGRAM:
+    create_anagram_links();
+    break;
+  default:
+    create_inflection_links();
+    break;
+  }
+}
+
+void ensure_relationship_links(void) {
+  for (int kind = 0; kind < RELATION_COUNT; kind++) {
+    ensure_relation_links((RelationKind)kind);
+  }
+}
+
+/* Deferred links of one word, searched for that word alone */
+void ensure_word_links(WordNode *node) {
+  if (node == NULL || node->clean_word == NULL || g_deferred_links == 0) {
+    return;
+  }
+
+  unsigned int missing = g_deferred_links & ~(unsigned int)node->valid_links;
+  if (missing == 0) {
+    return;
+  }
+
+  ensure_relationship_indexes();
+
+  /* Without room to remember the word, its links are not cached */
+  bool cached = node->valid_links != 0 || remember_checked_word(node);
+
+  for (int kind = 0; kind < RELATION_COUNT; kind++) {
+    if (missing & INDEX_BIT(kind)) {
+      set_link(node, (RelationKind)kind, g_link_finders[kind](node));
+    }
+  }
+
+  if (cached) {
+    node->valid_links |= (unsigned short)missing;
+  }
+}
+
+/* Snapshot restore */
+
+void restore_relationship_links(WordNode *node,
+                                WordNode *const targets[RELATION_COUNT]) {
+  if (node == NULL || targets == NULL) {
+    return;
+  }
+
+  for (int kind = 0; kind < RELATION_COUNT; kind++) {
+    set_link(node, (RelationKind)kind, targets[kind]);
+  }
+
+  g_pending_indexes = ALL_INDEX_BITS;
+}
+
+/* Pending indexes side by side, one task each, as in a full rebuild */
+static bool build_indexes_in_parallel(unsigned int pending) {
+  WordSet words;
+  if (!collect_words(&words)) {
+    return false;
+  }
+
+  ParallelLoop indexes[RELATION_COUNT];
+  int count = 0;
+  if (pending & INDEX_BIT(RELATION_SUBWORD)) {
+    indexes[count++] = (ParallelLoop){index_subwords, &words, words.count,
+                                      words.count};
+  }
+  if (pending & INDEX_BIT(RELATION_ED_FORM)) {
+    indexes[count++] = (ParallelLoop){index_inflections, &words,
+                                      words.count, words.count};
+  }
+  if (pending & INDEX_BIT(RELATION_ADD_ONE_CHAR)) {
+    indexes[count++] = (ParallelLoop){index_deletion_patterns, &words,
+                                      words.count, words.count};
+  }
+  if (pending & INDEX_BIT(RELATION_LEXICALLY_CLOSE)) {
+    indexes[count++] = (ParallelLoop){index_lexical_patterns, &words,
+                                      words.count, words.count};
+  }
+  if (pending & INDEX_BIT(RELATION_ANAGRAM)) {
+    indexes[count++] = (ParallelLoop){index_anagram_classes, &words,
+                                      words.count, words.count};
+  }
+  run_parallel_loops(indexes, count);
+
+  free(words.nodes);
+  return true;
+}
+
+/*
+ * Register every word in the indexes still pending, without relinking.
+ * skip is a word already in the lists that its caller registers itself.
+ */
+static void build_pending_indexes(const WordNode *skip) {
+  if (g_pending_indexes == 0) {
+    return;
+  }
+
+  unsigned int pending = g_pending_indexes;
+  g_pending_indexes = 0;
 
-    while (current != NULL) {
-      current->anagram = NULL;
-      bool found_self = false;
+  /* With no word to leave out, the indexes can be built side by side */
+  if (skip == NULL && build_indexes_in_parallel(pending)) {
+    return;
+  }
 
-      if (current->clean_word == NULL ||
-          current->alphabetically_sorted == NULL) {
-        current = current->next;
+  /* Visiting words in list order keeps every bucket append-only */
+  for (int i = 0; i < ALPHABET_SIZE; i++) {
+    const LetterList *list = &g_word_lists[i];
+
+    for (int pos = 0; pos < list->count; pos++) {
+      WordNode *current = word_node_at(list->ids[pos]);
+      if (current == skip || current->clean_word == NULL) {
         continue;
       }
 
-      for (int j = 0; j < ALPHABET_SIZE; j++) {
-        WordNode *candidate = g_word_lists[j].head;
-
-        while (candidate != NULL) {
-          if (candidate == current) {
-            found_self = true;
-          } else if (found_self && candidate->clean_word != NULL &&
-                     candidate->alphabetically_sorted != NULL &&
-                     strcmp(current->clean_word, candidate->clean_word) != 0 &&
-                     strcmp(current->alphabetically_sorted,
-                            candidate->alphabetically_sorted) == 0) {
-            current->anagram = candidate;
-            link_count++;
-            break;
-          }
-          candidate = candidate->next;
-        }
+      if ((pending & INDEX_BIT(RELATION_SUBWORD)) &&
+          !add_to_length_group(current)) {
+        fprintf(stderr, "Error: Unable to allocate memory for subwords.\n");
+      }
+      if (pending & INDEX_BIT(RELATION_ED_FORM)) {
+        register_inflections(current);
+      }
+      if (pending & INDEX_BIT(RELATION_ADD_ONE_CHAR)) {
+        update_deletion_patterns(current, true);
+      }
+      if (pending & INDEX_BIT(RELATION_LEXICALLY_CLOSE)) {
+        update_lexical_patterns(current, true);
+      }
+      if (pending & INDEX_BIT(RELATION_ANAGRAM)) {
+        current->anagram_class = add_to_anagram_class(current);
+      }
+    }
+  }
+}
 
-        if (current->anagram != NULL) {
-          break;
-        }
+void ensure_relationship_indexes(void) { build_pending_indexes(NULL); }
+
+/* Build one pending index, leaving the others for later */
+static void build_pending_index(RelationKind kind) {
+  if ((g_pending_indexes & INDEX_BIT(kind)) == 0) {
+    return;
+  }
+
+  unsigned int others = g_pending_indexes & ~INDEX_BIT(kind);
+  g_pending_indexes = INDEX_BIT(kind);
+  build_pending_indexes(NULL);
+  g_pending_indexes |= others;
+}
+
+void ensure_anagram_classes(void) { build_pending_index(RELATION_ANAGRAM); }
+
+/* Incremental maintenance */
+
+void add_word_relationships(WordNode *node) {
+  if (node == NULL || node->clean_word == NULL) {
+    return;
+  }
+
+  build_pending_indexes(node);
+
+  /* Relations still deferred are only indexed; cached links are dropped */
+  invalidate_word_links();
+
+  /* Subwords: the node's own superword, then shorter words it contains */
+  if (add_to_length_group(node) && !links_deferred(RELATION_SUBWORD)) {
+    set_link(node, RELATION_SUBWORD, find_subword_of(node));
+  }
+  if (!links_deferred(RELATION_SUBWORD)) {
+    link_subwords_of(node);
+  }
+
+  /* Inflections in both directions */
+  if (links_deferred(RELATION_ED_FORM)) {
+    register_inflections(node);
+  } else {
+    link_inflections(node);
+    link_inflection_bases(node);
+  }
+
+  /* One character added, in both directions */
+  update_deletion_patterns(node, true);
+  if (!links_deferred(RELATION_ADD_ONE_CHAR)) {
+    set_link(node, RELATION_ADD_ONE_CHAR, find_add_one_char(node));
+    link_one_char_bases(node);
+  }
+
+  /* Lexically close words */
+  update_lexical_patterns(node, true);
+  if (!links_deferred(RELATION_LEXICALLY_CLOSE)) {
+    set_link(node, RELATION_LEXICALLY_CLOSE, find_lexically_close(node));
+    link_earlier_neighbours(node);
+  }
+
+  /* Anagram class: splice the node between its neighbours in the class */
+  node->anagram_class = add_to_anagram_class(node);
+  if (node->anagram_class != NULL && !links_deferred(RELATION_ANAGRAM)) {
+    const WordBucket *class = node->anagram_class;
+    for (int k = 1; k < class->count; k++) {
+      if (class->nodes[k] == node) {
+        set_link(class->nodes[k - 1], RELATION_ANAGRAM, node);
+        break;
       }
+    }
+    set_link(node, RELATION_ANAGRAM, find_next_anagram(node));
+  }
+}
+
+void remove_word_relationships(WordNode *node) {
+  if (node == NULL || node->clean_word == NULL) {
+    return;
+  }
 
-      current = current->next;
+  ensure_relationship_indexes();
+  invalidate_word_links();
+
+  /* Take the node out of every relationship index */
+  remove_from_length_group(node);
+  unregister_inflections(node);
+  update_deletion_patterns(node, false);
+  update_lexical_patterns(node, false);
+  if (node->anagram_class != NULL) {
+    remove_from_anagram_class(node);
+  }
+
+  /* Drop its own links */
+  for (int kind = 0; kind < RELATION_COUNT; kind++) {
+    set_link(node, (RelationKind)kind, NULL);
+  }
+
+  /* Relink every word that pointed at it; the indexes no longer see it */
+  while (node->backlink_count > 0) {
+    Backlink backlink = node->backlinks[node->backlink_count - 1];
+    WordNode *source = word_node_at(backlink.source);
+    WordNode *replacement = NULL;
+
+    /* Deferred links are searched again on first use */
+    if (links_deferred(backlink.kind)) {
+      set_link(source, backlink.kind, NULL);
+      continue;
     }
+
+    switch (backlink.kind) {
+    case RELATION_SUBWORD:
+      replacement = find_subword_of(source);
+      break;
+    case RELATION_ADD_ONE_CHAR:
+      replacement = find_add_one_char(source);
+      break;
+    case RELATION_LEXICALLY_CLOSE:
+      replacement = find_lexically_close(source);
+      break;
+    case RELATION_ANAGRAM:
+      replacement = find_next_anagram(source);
+      break;
+    default:
+      /* A generated inflection names exactly one word */
+      break;
+    }
+
+    set_link(source, backlink.kind, replacement);
   }
+}
 
-  return link_count;
-}
\ No newline at end of file
+/* Index cleanup */
+
+void free_relationship_indexes(void) {
+  clear_length_groups();
+  clear_inflection_bases();
+  bucket_table_clear(&g_deletion_patterns);
+  bucket_table_clear(&g_lexical_patterns);
+  bucket_table_clear(&g_anagram_classes);
+  memset(g_link_counts, 0, sizeof(g_link_counts));
+  g_pending_indexes = 0;
+
+  free(g_checked_ids);
+  g_checked_ids = NULL;
+  g_checked_count = 0;
+  g_checked_capacity = 0;
+  g_deferred_links = 0;
+  g_lazy_links = false;
+}
@@ -0,0 +1,311 @@
+/**
+ * Thread Pool
+ * Work-stealing workers for loops whose iterations are independent
+ *
+ * A run takes several loops at once, so independent passes share the
+ * workers. Each loop is cut into chunks of grain iterations; the chunks
+ * are dealt out as one contiguous run per worker queue, which a worker
+ * takes from the front in order. A worker whose queue is empty steals
+ * from the back of another queue, so a few expensive chunks do not leave
+ * the other cores idle. The calling thread works as queue 0 and returns
+ * once every chunk has finished. Workers are started on first use, one
+ * per online core.
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../../include/english_words.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#define THREAD_POOL_MAX_THREADS 64
+
+typedef struct {
+  const ParallelLoop *loop;
+  size_t begin;
+  size_t end;
+} ParallelChunk;
+
+static void run_chunk(const ParallelChunk *chunk) {
+  chunk->loop->body(chunk->loop->context, chunk->begin, chunk->end);
+}
+
+/* Split every loop into chunks, in loop order */
+static ParallelChunk *split_loops(const ParallelLoop *loops, int loop_count,
+                                  size_t *chunk_count) {
+  size_t count = 0;
+  for (int l = 0; l < loop_count; l++) {
+    size_t grain = loops[l].grain > 0 ? loops[l].grain : 1;
+    count += (loops[l].count + grain - 1) / grain;
+  }
+
+  *chunk_count = count;
+  ParallelChunk *chunks =
+      (ParallelChunk *)malloc((count > 0 ? count : 1) * sizeof(ParallelChunk));
+  if (chunks == NULL) {
+    return NULL;
+  }
+
+  size_t c = 0;
+  for (int l = 0; l < loop_count; l++) {
+    size_t grain = loops[l].grain > 0 ? loops[l].grain : 1;
+    for (size_t begin = 0; begin < loops[l].count; begin += grain) {
+      chunks[c].loop = &loops[l];
+      chunks[c].begin = begin;
+      chunks[c].end =
+          loops[l].count - begin > grain ? begin + grain : loops[l].count;
+      c++;
+    }
+  }
+  return chunks;
+}
+
+static void run_loops_serially(const ParallelLoop *loops, int loop_count) {
+  for (int l = 0; l < loop_count; l++) {
+    if (loops[l].count > 0) {
+      loops[l].body(loops[l].context, 0, loops[l].count);
+    }
+  }
+}
+
+#ifdef _WIN32
+
+bool start_thread_pool(int thread_count) {
+  (void)thread_count;
+  return true;
+}
+
+void stop_thread_pool(void) {}
+
+int get_thread_pool_size(void) { return 1; }
+
+void run_parallel_loops(const ParallelLoop *loops, int loop_count) {
+  run_loops_serially(loops, loop_count);
+}
+
+#else
+
+/* Chunks [head, tail) of one worker; the owner takes head, thieves tail */
+typedef struct {
+  pthread_mutex_t lock;
+  ParallelChunk *chunks;
+  size_t head;
+  size_t tail;
+} WorkQueue;
+
+static WorkQueue g_queues[THREAD_POOL_MAX_THREADS];
+static pthread_t g_workers[THREAD_POOL_MAX_THREADS];
+static int g_thread_count = 0; /* Workers plus the calling thread */
+
+/* Pool state below is guarded by g_pool_lock */
+static pthread_mutex_t g_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_work_ready = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t g_work_done = PTHREAD_COND_INITIALIZER;
+static unsigned long g_generation = 0; /* Bumped for every run */
+static int g_busy = 0;                 /* Workers inside the current run */
+static bool g_stopping = false;
+
+/* Queue operations */
+
+static bool take_chunk(WorkQueue *queue, ParallelChunk *chunk) {
+  pthread_mutex_lock(&queue->lock);
+  bool taken = queue->head < queue->tail;
+  if (taken) {
+    *chunk = queue->chunks[queue->head++];
+  }
+  pthread_mutex_unlock(&queue->lock);
+  return taken;
+}
+
+static bool steal_chunk(WorkQueue *queue, ParallelChunk *chunk) {
+  pthread_mutex_lock(&queue->lock);
+  bool taken = queue->head < queue->tail;
+  if (taken) {
+    *chunk = queue->chunks[--queue->tail];
+  }
+  pthread_mutex_unlock(&queue->lock);
+  return taken;
+}
+
+static void set_queue(WorkQueue *queue, ParallelChunk *chunks, size_t head,
+                      size_t tail) {
+  pthread_mutex_lock(&queue->lock);
+  queue->chunks = chunks;
+  queue->head = head;
+  queue->tail = tail;
+  pthread_mutex_unlock(&queue->lock);
+}
+
+/* Run chunks from the worker's own queue, then from the others' */
+static void work(int self) {
+  ParallelChunk chunk;
+
+  for (;;) {
+    if (take_chunk(&g_queues[self], &chunk)) {
+      run_chunk(&chunk);
+      continue;
+    }
+
+    bool stolen = false;
+    for (int offset = 1; offset < g_thread_count && !stolen; offset++) {
+      stolen = steal_chunk(&g_queues[(self + offset) % g_thread_count],
+                           &chunk);
+    }
+    if (!stolen) {
+      return;
+    }
+    run_chunk(&chunk);
+  }
+}
+
+static void *worker_main(void *arg) {
+  int self = (int)(intptr_t)arg;
+  unsigned long seen = 0;
+
+  pthread_mutex_lock(&g_pool_lock);
+  for (;;) {
+    while (!g_stopping && g_generation == seen) {
+      pthread_cond_wait(&g_work_ready, &g_pool_lock);
+    }
+    if (g_stopping) {
+      break;
+    }
+
+    seen = g_generation;
+    g_busy++;
+    pthread_mutex_unlock(&g_pool_lock);
+
+    work(self);
+
+    pthread_mutex_lock(&g_pool_lock);
+    if (--g_busy == 0) {
+      pthread_cond_signal(&g_work_done);
+    }
+  }
+  pthread_mutex_unlock(&g_pool_lock);
+  return NULL;
+}
+
+static int get_core_count(void) {
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  if (cores < 1) {
+    return 1;
+  }
+  return cores > THREAD_POOL_MAX_THREADS ? THREAD_POOL_MAX_THREADS
+                                         : (int)cores;
+}
+
+/* Pool management */
+
+bool start_thread_pool(int thread_count) {
+  stop_thread_pool();
+
+  if (thread_count <= 0) {
+    thread_count = get_core_count();
+  }
+  if (thread_count > THREAD_POOL_MAX_THREADS) {
+    thread_count = THREAD_POOL_MAX_THREADS;
+  }
+
+  for (int i = 0; i < thread_count; i++) {
+    pthread_mutex_init(&g_queues[i].lock, NULL);
+    g_queues[i].chunks = NULL;
+    g_queues[i].head = 0;
+    g_queues[i].tail = 0;
+  }
+
+  g_stopping = false;
+  g_generation = 0;
+  g_thread_count = 1;
+
+  /* The calling thread is worker 0; fewer threads is not an error */
+  for (int i = 1; i < thread_count; i++) {
+    if (pthread_create(&g_workers[i], NULL, worker_main,
+                       (void *)(intptr_t)i) != 0) {
+      fprintf(stderr, "Warning: Started %d of %d worker threads.\n", i - 1,
+              thread_count - 1);
+      break;
+    }
+    g_thread_count++;
+  }
+  return g_thread_count == thread_count;
+}
+
+void stop_thread_pool(void) {
+  if (g_thread_count == 0) {
+    return;
+  }
+
+  pthread_mutex_lock(&g_pool_lock);
+  g_stopping = true;
+  pthread_cond_broadcast(&g_work_ready);
+  pthread_mutex_unlock(&g_pool_lock);
+
+  for (int i = 1; i < g_thread_count; i++) {
+    pthread_join(g_workers[i], NULL);
+  }
+  for (int i = 0; i < g_thread_count; i++) {
+    pthread_mutex_destroy(&g_queues[i].lock);
+  }
+  g_thread_count = 0;
+}
+
+int get_thread_pool_size(void) {
+  if (g_thread_count == 0) {
+    start_thread_pool(0);
+  }
+  return g_thread_count;
+}
+
+void run_parallel_loops(const ParallelLoop *loops, int loop_count) {
+  if (loops == NULL || loop_count <= 0) {
+    return;
+  }
+
+  if (get_thread_pool_size() == 1) {
+    run_loops_serially(loops, loop_count);
+    return;
+  }
+
+  size_t chunk_count;
+  ParallelChunk *chunks = split_loops(loops, loop_count, &chunk_count);
+  if (chunks == NULL) {
+    run_loops_serially(loops, loop_count);
+    return;
+  }
+
+  /* Deal the chunks out as one contiguous run per queue */
+  for (int i = 0; i < g_thread_count; i++) {
+    size_t head = chunk_count * (size_t)i / (size_t)g_thread_count;
+    size_t tail = chunk_count * (size_t)(i + 1) / (size_t)g_thread_count;
+    set_queue(&g_queues[i], chunks, head, tail);
+  }
+
+  pthread_mutex_lock(&g_pool_lock);
+  g_generation++;
+  pthread_cond_broadcast(&g_work_ready);
+  pthread_mutex_unlock(&g_pool_lock);
+
+  work(0);
+
+  /* Every queue is empty; wait for the chunks still running elsewhere */
+  pthread_mutex_lock(&g_pool_lock);
+  while (g_busy > 0) {
+    pthread_cond_wait(&g_work_done, &g_pool_lock);
+  }
+  pthread_mutex_unlock(&g_pool_lock);
+
+  for (int i = 0; i < g_thread_count; i++) {
+    set_queue(&g_queues[i], NULL, 0, 0);
+  }
+  free(chunks);
+}
+
+#endif /* _WIN32 */
@@ -32,10 +32,11 @@ int count_vowels(const char *word) {
     return 0;
 
   int count = 0;
-  for (int i = 0; word[i] != '\0'; i++) {
-    if (is_vowel(word[i])) {
-      count++;
-    }
+  size_t len = strlen(word);
+  for (size_t i = 0; i < len; i += CHAR_CLASS_WINDOW) {
+    CharClasses classes;
+    classify_characters(word + i, len - i, &classes);
+    count += count_bits(classes.vowels);
   }
   return count;
 }
@@ -45,10 +46,11 @@ int count_consonants(const char *word) {
     return 0;
 
   int count = 0;
-  for (int i = 0; word[i] != '\0'; i++) {
-    if (is_consonant(word[i])) {
-      count++;
-    }
+  size_t len = strlen(word);
+  for (size_t i = 0; i < len; i += CHAR_CLASS_WINDOW) {
+    CharClasses classes;
+    classify_characters(word + i, len - i, &classes);
+    count += count_bits(classes.letters & ~classes.vowels);
   }
   return count;
 }
@@ -72,26 +74,68 @@ int count_syllables(const char *word) {
   return count;
 }
 
-/* Word transformation operations */
+unsigned int compute_letter_mask(const char *word) {
+  if (word == NULL)
+    return 0;
+
+  unsigned int mask = 0;
+  for (int i = 0; word[i] != '\0'; i++) {
+    if (isalpha((unsigned char)word[i])) {
+      mask |= 1u << (tolower((unsigned char)word[i]) - 'a');
+    }
+  }
+  return mask;
+}
+
+void count_letters(const char *word, unsigned char counts[ALPHABET_SIZE]) {
+  memset(counts, 0, ALPHABET_SIZE);
 
-char *remove_slashes(const char *word) {
   if (word == NULL)
-    return NULL;
+    return;
 
-  size_t len = strlen(word);
-  char *result = (char *)malloc(len + 1);
-  if (result == NULL) {
-    return NULL;
+  for (int i = 0; word[i] != '\0'; i++) {
+    if (isalpha((unsigned char)word[i])) {
+      counts[tolower((unsigned char)word[i]) - 'a']++;
+    }
   }
+}
+
+/* Word transformation operations */
+
+/*
+ * The *_into functions write into the caller's buffer and fail if it is too
+ * small; the allocating versions wrap them.
+ */
+
+bool remove_slashes_into(const char *word, char *clean, size_t size) {
+  if (word == NULL || clean == NULL || size == 0)
+    return false;
 
   size_t j = 0;
-  for (size_t i = 0; i < len; i++) {
+  for (size_t i = 0; word[i] != '\0'; i++) {
     if (word[i] != '/') {
-      result[j++] = word[i];
+      if (j + 1 == size) {
+        return false;
+      }
+      clean[j++] = word[i];
     }
   }
-  result[j] = '\0';
+  clean[j] = '\0';
+
+  return true;
+}
+
+char *remove_slashes(const char *word) {
+  if (word == NULL)
+    return NULL;
+
+  size_t size = strlen(word) + 1;
+  char *result = (char *)malloc(size);
+  if (result == NULL) {
+    return NULL;
+  }
 
+  remove_slashes_into(word, result, size);
   return result;
 }
 
@@ -108,30 +152,46 @@ bool is_word_alphabetically_ordered(const char *word) {
   return true;
 }
 
+/* Letters only: the counting sort has no place for other characters */
+bool sort_word_alphabetically_into(const char *word, char *sorted,
+                                   size_t size) {
+  if (word == NULL || sorted == NULL)
+    return false;
+
+  size_t len = strlen(word);
+  if (len + 1 > size || len >= MAX_WORD_LENGTH) {
+    return false;
+  }
+
+  unsigned char counts[ALPHABET_SIZE];
+  count_letters(word, counts);
+
+  size_t letters = 0;
+  for (int i = 0; i < ALPHABET_SIZE; i++) {
+    letters += counts[i];
+  }
+  if (letters != len) {
+    return false;
+  }
+
+  sort_letters(word, counts, sorted);
+  return true;
+}
+
 char *sort_word_alphabetically(const char *word) {
   if (word == NULL)
     return NULL;
 
-  size_t len = strlen(word);
-  char *sorted = (char *)malloc(len + 1);
+  size_t size = strlen(word) + 1;
+  char *sorted = (char *)malloc(size);
   if (sorted == NULL) {
     return NULL;
   }
 
-  strcpy(sorted, word);
-
-  /* Simple bubble sort */
-  for (size_t i = 0; i < len - 1; i++) {
-    for (size_t j = i + 1; j < len; j++) {
-      if (tolower((unsigned char)sorted[i]) >
-          tolower((unsigned char)sorted[j])) {
-        char temp = sorted[i];
-        sorted[i] = sorted[j];
-        sorted[j] = temp;
-      }
-    }
+  if (!sort_word_alphabetically_into(word, sorted, size)) {
+    free(sorted);
+    return NULL;
   }
-
   return sorted;
 }
 
@@ -144,22 +204,28 @@ bool is_valid_word_format(const char *word) {
   if (len >= MAX_WORD_LENGTH)
     return false;
 
+  CharClasses classes;
+  classify_characters(word, len, &classes);
+  return is_valid_word_classes(&classes, len);
+}
+
+/* The format checks of is_valid_word_format on an already classified word
+ * of 1 to MAX_WORD_LENGTH - 1 characters */
+bool is_valid_word_classes(const CharClasses *classes, size_t length) {
+  uint64_t slashes = classes->slashes;
+
   /* Check for valid characters (letters and slashes only) */
-  for (size_t i = 0; i < len; i++) {
-    if (!isalpha((unsigned char)word[i]) && word[i] != '/') {
-      return false;
-    }
+  if (count_bits(classes->letters | slashes) != (int)length) {
+    return false;
   }
 
   /* Check for consecutive slashes */
-  for (size_t i = 0; i < len - 1; i++) {
-    if (word[i] == '/' && word[i + 1] == '/') {
-      return false;
-    }
+  if ((slashes & (slashes >> 1)) != 0) {
+    return false;
   }
 
   /* Check for leading/trailing slashes */
-  if (word[0] == '/' || word[len - 1] == '/') {
+  if ((slashes & 1) != 0 || ((slashes >> (length - 1)) & 1) != 0) {
     return false;
   }
 
@@ -172,8 +238,12 @@ int get_word_letter_index(const char *word) {
   }
 
   /* Check if word contains only alphabetic characters and slashes */
-  for (int i = 0; word[i] != '\0'; i++) {
-    if (!isalpha((unsigned char)word[i]) && word[i] != '/') {
+  size_t len = strlen(word);
+  for (size_t i = 0; i < len; i += CHAR_CLASS_WINDOW) {
+    size_t window = len - i < CHAR_CLASS_WINDOW ? len - i : CHAR_CLASS_WINDOW;
+    CharClasses classes;
+    classify_characters(word + i, window, &classes);
+    if (count_bits(classes.letters | classes.slashes) != (int)window) {
       return INVALID_LIST_INDEX;
     }
   }
@@ -182,90 +252,93 @@ int get_word_letter_index(const char *word) {
   return toupper((unsigned char)word[0]) - 'A';
 }
 
-/* Syllable operations */
+/* Full analysis */
 
-Syllable *parse_syllables(const char *word) {
-  if (word == NULL)
-    return NULL;
+/* Bit i set if letter 'a' + i counts as a vowel (a, e, i, o, u, y) */
+#define VOWEL_LETTERS                                                         \
+  ((1u << ('a' - 'a')) | (1u << ('e' - 'a')) | (1u << ('i' - 'a')) |         \
+   (1u << ('o' - 'a')) | (1u << ('u' - 'a')) | (1u << ('y' - 'a')))
 
-  Syllable *head = NULL;
-  Syllable *tail = NULL;
-  char buffer[MAX_SYLLABLE_LENGTH];
-  int buffer_index = 0;
+/*
+ * Counting sort of a word of letters whose per-letter counts are known:
+ * letters ordered case-insensitively, ties kept in order. This is the
+ * signature shared by anagrams.
+ */
+void sort_letters(const char *word, const unsigned char counts[ALPHABET_SIZE],
+                  char *sorted) {
+  unsigned char offsets[ALPHABET_SIZE];
+  unsigned char out = 0;
+  for (int letter = 0; letter < ALPHABET_SIZE; letter++) {
+    offsets[letter] = out;
+    out = (unsigned char)(out + counts[letter]);
+  }
 
-  for (int i = 0; word[i] != '\0'; i++) {
-    if (word[i] == '/') {
-      if (buffer_index > 0) {
-        buffer[buffer_index] = '\0';
-
-        Syllable *new_syll = allocate_syllable();
-        if (new_syll == NULL) {
-          /* Free what we've allocated so far */
-          while (head != NULL) {
-            Syllable *temp = head->next;
-            free_syllable(head);
-            head = temp;
-          }
-          return NULL;
-        }
-
-        strncpy(new_syll->text, buffer, MAX_SYLLABLE_LENGTH - 1);
-        new_syll->text[MAX_SYLLABLE_LENGTH - 1] = '\0';
-        new_syll->next = NULL;
-
-        if (head == NULL) {
-          head = new_syll;
-          tail = new_syll;
-        } else {
-          tail->next = new_syll;
-          tail = new_syll;
-        }
-
-        buffer_index = 0;
-      }
-    } else {
-      if (buffer_index < MAX_SYLLABLE_LENGTH - 1) {
-        buffer[buffer_index++] = word[i];
-      }
-    }
+  size_t length = 0;
+  for (; word[length] != '\0'; length++) {
+    char c = word[length];
+    sorted[offsets[(c | 0x20) - 'a']++] = c;
   }
+  sorted[length] = '\0';
+}
 
-  /* Add the last syllable */
-  if (buffer_index > 0) {
-    buffer[buffer_index] = '\0';
-
-    Syllable *new_syll = allocate_syllable();
-    if (new_syll == NULL) {
-      /* Free what we've allocated so far */
-      while (head != NULL) {
-        Syllable *temp = head->next;
-        free_syllable(head);
-        head = temp;
-      }
-      return NULL;
-    }
+/*
+ * Compute every derived field in one pass over the word, writing only into
+ * the caller's analysis. Defined for words of ASCII letters and slashes.
+ */
+bool analyze_word(const char *word, WordAnalysis *analysis) {
+  if (word == NULL || analysis == NULL) {
+    return false;
+  }
 
-    strncpy(new_syll->text, buffer, MAX_SYLLABLE_LENGTH - 1);
-    new_syll->text[MAX_SYLLABLE_LENGTH - 1] = '\0';
-    new_syll->next = NULL;
+  memset(analysis->letter_counts, 0, ALPHABET_SIZE);
 
-    if (head == NULL) {
-      head = new_syll;
-    } else {
-      tail->next = new_syll;
-    }
-  }
+  size_t length = 0;
+  int vowels = 0;
+  int syllables = 1;
+  uint64_t breaks = 0;
+  unsigned int mask = 0;
+  bool ordered = true;
+  unsigned char previous = 0;
 
-  return head;
-}
+  for (const char *p = word; *p != '\0'; p++) {
+    char c = *p;
+
+    if (c == '/') {
+      syllables++;
+      breaks |= (uint64_t)1 << length;
+      continue;
+    }
 
-void print_syllable_list(const Syllable *syllables) {
-  const Syllable *current = syllables;
-  while (current != NULL) {
-    printf("%s", current->text);
-    if (current->next != NULL) {
-      printf(" / ");
+    /* Setting the case bit maps A-Z onto a-z and nothing else onto it */
+    unsigned char lower = (unsigned char)(c | 0x20);
+    unsigned int letter = (unsigned int)lower - 'a';
+    if (letter >= ALPHABET_SIZE || length == MAX_WORD_LENGTH - 1) {
+      return false;
     }
-    current = current->next;
+
+    analysis->clean_word[length++] = c;
+
+    ordered &= lower >= previous;
+    previous = lower;
+
+    analysis->letter_counts[letter]++;
+    mask |= 1u << letter;
+    vowels += (VOWEL_LETTERS >> letter) & 1u;
   }
-}
\ No newline at end of file
+
+  if (length == 0) {
+    return false;
+  }
+
+  /* Slashes before the first letter or after the last start nothing */
+  analysis->syllable_breaks = breaks & ~(uint64_t)1 &
+                              (((uint64_t)1 << length) - 1);
+  analysis->clean_word[length] = '\0';
+  analysis->char_count = (int)length;
+  analysis->vowel_count = vowels;
+  analysis->consonant_count = (int)length - vowels;
+  analysis->syllable_count = syllables;
+  analysis->is_alphabetically_ordered = ordered;
+  analysis->letter_mask = mask;
+  return true;
+}
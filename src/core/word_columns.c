@@ -0,0 +1,345 @@
+/**
+ * Word Columns
+ * Per-word counts mirrored into dense columns for filters and aggregates
+ *
+ * Each column holds one byte per node table slot, so a query over the
+ * whole dictionary is a handful of branch-free passes over contiguous
+ * arrays that the compiler turns into vector code, instead of a walk over
+ * every node. Slots of deleted nodes are cleared in the live column and
+ * never match.
+ */
+
+#include "../../include/english_words.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COLUMNS_INITIAL_CAPACITY 1024 /* Must be a multiple of COLUMN_BLOCK */
+
+static unsigned char *g_columns[COLUMN_COUNT];
+static unsigned char *g_live = NULL;
+static size_t g_column_capacity = 0;
+static size_t g_column_size = 0; /* Highest slot in use plus one */
+
+/* Names accepted in queries, first one per column used for display */
+static const struct {
+  const char *name;
+  WordColumn column;
+} g_column_names[] = {
+    {"length", COLUMN_CHARACTERS},
+    {"chars", COLUMN_CHARACTERS},
+    {"characters", COLUMN_CHARACTERS},
+    {"consonants", COLUMN_CONSONANTS},
+    {"vowels", COLUMN_VOWELS},
+    {"syllables", COLUMN_SYLLABLES},
+    {"ordered", COLUMN_ORDERED},
+};
+
+#define COLUMN_NAME_COUNT (sizeof(g_column_names) / sizeof(g_column_names[0]))
+
+/* Column storage */
+
+static bool grow_columns(size_t needed) {
+  size_t new_capacity =
+      g_column_capacity == 0 ? COLUMNS_INITIAL_CAPACITY : g_column_capacity;
+  while (new_capacity < needed) {
+    new_capacity *= 2;
+  }
+
+  unsigned char **arrays[COLUMN_COUNT + 1];
+  for (int c = 0; c < COLUMN_COUNT; c++) {
+    arrays[c] = &g_columns[c];
+  }
+  arrays[COLUMN_COUNT] = &g_live;
+
+  /* Arrays already grown stay valid even if a later one fails */
+  for (int c = 0; c <= COLUMN_COUNT; c++) {
+    unsigned char *grown = (unsigned char *)realloc(*arrays[c], new_capacity);
+    if (grown == NULL) {
+      fprintf(stderr, "Error: Unable to allocate memory for word columns.\n");
+      return false;
+    }
+    memset(grown + g_column_capacity, 0, new_capacity - g_column_capacity);
+    *arrays[c] = grown;
+  }
+
+  g_column_capacity = new_capacity;
+  return true;
+}
+
+static unsigned char to_column_value(int value) {
+  return (unsigned char)(value < 0 ? 0 : value > 255 ? 255 : value);
+}
+
+bool word_columns_set(const WordNode *node) {
+  if (node == NULL) {
+    return false;
+  }
+
+  size_t slot = node->id;
+  if (slot >= g_column_capacity && !grow_columns(slot + 1)) {
+    return false;
+  }
+
+  g_columns[COLUMN_CHARACTERS][slot] = to_column_value(node->char_count);
+  g_columns[COLUMN_CONSONANTS][slot] = to_column_value(node->consonant_count);
+  g_columns[COLUMN_VOWELS][slot] = to_column_value(node->vowel_count);
+  g_columns[COLUMN_SYLLABLES][slot] = to_column_value(get_syllable_count(node));
+  g_columns[COLUMN_ORDERED][slot] = node->is_alphabetically_ordered ? 1 : 0;
+  g_live[slot] = 1;
+
+  if (slot >= g_column_size) {
+    g_column_size = slot + 1;
+  }
+  return true;
+}
+
+void word_columns_remove(unsigned int id) {
+  if (id < g_column_size) {
+    g_live[id] = 0;
+  }
+}
+
+void word_columns_clear(void) {
+  for (int c = 0; c < COLUMN_COUNT; c++) {
+    free(g_columns[c]);
+    g_columns[c] = NULL;
+  }
+  free(g_live);
+  g_live = NULL;
+  g_column_capacity = 0;
+  g_column_size = 0;
+}
+
+/* Query parsing */
+
+const char *word_column_name(WordColumn column) {
+  for (size_t i = 0; i < COLUMN_NAME_COUNT; i++) {
+    if (g_column_names[i].column == column) {
+      return g_column_names[i].name;
+    }
+  }
+  return "?";
+}
+
+static bool parse_column_name(const char **text, WordColumn *column) {
+  const char *start = *text;
+  size_t length = 0;
+  while (isalpha((unsigned char)start[length])) {
+    length++;
+  }
+
+  for (size_t i = 0; i < COLUMN_NAME_COUNT; i++) {
+    if (strlen(g_column_names[i].name) == length &&
+        strncmp(g_column_names[i].name, start, length) == 0) {
+      *column = g_column_names[i].column;
+      *text = start + length;
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool parse_operator(const char **text, QueryOperator *op) {
+  const char *p = *text;
+
+  if (p[0] == '<' && p[1] == '=') {
+    *op = QUERY_LESS_EQUAL;
+  } else if (p[0] == '>' && p[1] == '=') {
+    *op = QUERY_GREATER_EQUAL;
+  } else if (p[0] == '!' && p[1] == '=') {
+    *op = QUERY_NOT_EQUAL;
+  } else if (p[0] == '=' && p[1] == '=') {
+    *op = QUERY_EQUAL;
+  } else if (p[0] == '<') {
+    *op = QUERY_LESS;
+  } else if (p[0] == '>') {
+    *op = QUERY_GREATER;
+  } else if (p[0] == '=') {
+    *op = QUERY_EQUAL;
+  } else {
+    return false;
+  }
+
+  *text = p + ((p[1] == '=') ? 2 : 1);
+  return true;
+}
+
+static void skip_separators(const char **text) {
+  while (isspace((unsigned char)**text) || **text == ',') {
+    (*text)++;
+  }
+}
+
+int parse_word_query(const char *text, QueryCondition *conditions,
+                     int max_conditions) {
+  if (text == NULL || conditions == NULL) {
+    return -1;
+  }
+
+  int count = 0;
+  skip_separators(&text);
+
+  while (*text != '\0') {
+    /* "and" between terms is optional */
+    if (strncmp(text, "and", 3) == 0 &&
+        (isspace((unsigned char)text[3]) || text[3] == ',')) {
+      text += 3;
+      skip_separators(&text);
+      continue;
+    }
+
+    if (count == max_conditions) {
+      return -1;
+    }
+
+    QueryCondition *condition = &conditions[count];
+    if (!parse_column_name(&text, &condition->column)) {
+      return -1;
+    }
+
+    while (*text == ' ') {
+      text++;
+    }
+    if (!parse_operator(&text, &condition->op)) {
+      return -1;
+    }
+    while (*text == ' ') {
+      text++;
+    }
+
+    if (!isdigit((unsigned char)*text)) {
+      return -1;
+    }
+    long value = 0;
+    while (isdigit((unsigned char)*text)) {
+      value = value * 10 + (*text - '0');
+      if (value > 255) {
+        return -1;
+      }
+      text++;
+    }
+    condition->value = (unsigned char)value;
+
+    count++;
+    if (*text != '\0' && !isspace((unsigned char)*text) && *text != ',') {
+      return -1;
+    }
+    skip_separators(&text);
+  }
+
+  return count;
+}
+
+/* Scans */
+
+/*
+ * Columns are scanned in fixed blocks. A block of constant size is
+ * vectorized even at -O2, and column capacity is always a whole number of
+ * blocks, with unused slots cleared in the live column.
+ */
+#define COLUMN_BLOCK 16
+
+#define FILTER_BLOCKS(test)                                                   \
+  for (size_t b = 0; b < blocks; b++) {                                       \
+    const unsigned char *restrict in = column + b * COLUMN_BLOCK;             \
+    unsigned char *restrict out = mask + b * COLUMN_BLOCK;                    \
+    for (int i = 0; i < COLUMN_BLOCK; i++) {                                  \
+      out[i] &= (unsigned char)(test);                                        \
+    }                                                                         \
+  }
+
+/* One loop per operator keeps each pass branch-free */
+static void filter_column(const unsigned char *column, QueryOperator op,
+                          unsigned char value, unsigned char *mask,
+                          size_t blocks) {
+  switch (op) {
+  case QUERY_EQUAL:
+    FILTER_BLOCKS(in[i] == value);
+    break;
+  case QUERY_NOT_EQUAL:
+    FILTER_BLOCKS(in[i] != value);
+    break;
+  case QUERY_LESS:
+    FILTER_BLOCKS(in[i] < value);
+    break;
+  case QUERY_LESS_EQUAL:
+    FILTER_BLOCKS(in[i] <= value);
+    break;
+  case QUERY_GREATER:
+    FILTER_BLOCKS(in[i] > value);
+    break;
+  case QUERY_GREATER_EQUAL:
+    FILTER_BLOCKS(in[i] >= value);
+    break;
+  }
+}
+
+static int count_matches(const unsigned char *mask, size_t blocks) {
+  int matches = 0;
+  for (size_t b = 0; b < blocks; b++) {
+    const unsigned char *block = mask + b * COLUMN_BLOCK;
+
+    /* At most COLUMN_BLOCK per block, so a byte sum cannot overflow */
+    unsigned char block_matches = 0;
+    for (int i = 0; i < COLUMN_BLOCK; i++) {
+      block_matches += block[i];
+    }
+    matches += block_matches;
+  }
+  return matches;
+}
+
+int run_word_query(const QueryCondition *conditions, int condition_count,
+                   WordNode **results, int max_results) {
+  if ((conditions == NULL && condition_count > 0) || g_column_size == 0) {
+    return 0;
+  }
+
+  size_t blocks = (g_column_size + COLUMN_BLOCK - 1) / COLUMN_BLOCK;
+  size_t count = blocks * COLUMN_BLOCK;
+  unsigned char *mask = (unsigned char *)malloc(count);
+  if (mask == NULL) {
+    fprintf(stderr, "Error: Unable to allocate memory for query.\n");
+    return -1;
+  }
+
+  memcpy(mask, g_live, count);
+  for (int c = 0; c < condition_count; c++) {
+    filter_column(g_columns[conditions[c].column], conditions[c].op,
+                  conditions[c].value, mask, blocks);
+  }
+
+  int matches = count_matches(mask, blocks);
+
+  /* Report the first matches in list order */
+  int found = 0;
+  for (int i = 0; i <= ALPHABET_SIZE && found < matches; i++) {
+    const LetterList *list = &g_word_lists[i];
+
+    for (int pos = 0; pos < list->count && found < max_results; pos++) {
+      unsigned int id = list->ids[pos];
+      if (mask[id]) {
+        results[found++] = word_node_at(id);
+      }
+    }
+  }
+
+  free(mask);
+  return matches;
+}
+
+void compute_word_histogram(WordColumn column, int bins[HISTOGRAM_BINS]) {
+  memset(bins, 0, HISTOGRAM_BINS * sizeof(int));
+  if ((unsigned int)column >= COLUMN_COUNT) {
+    return;
+  }
+
+  const unsigned char *values = g_columns[column];
+  for (size_t i = 0; i < g_column_size; i++) {
+    unsigned char value = values[i] < HISTOGRAM_BINS ? values[i]
+                                                     : HISTOGRAM_BINS - 1;
+    bins[value] += g_live[i];
+  }
+}
@@ -0,0 +1,162 @@
+/**
+ * Word Index
+ * Open-addressing hash index over clean words
+ *
+ * Every node stored in the letter lists is also registered here, keyed on
+ * its clean word, so lookups no longer have to walk the lists. The table
+ * uses linear probing with backward-shift deletion (no tombstones) and the
+ * hash of each word is cached on its node for rehashing and fast rejects.
+ */
+
+#include "../../include/english_words.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WORD_INDEX_INITIAL_CAPACITY 1024
+
+static WordNode **g_index_slots = NULL;
+static size_t g_index_capacity = 0;
+static size_t g_index_count = 0;
+
+/* Hashing */
+
+unsigned int hash_word(const char *word) {
+  /* 32-bit FNV-1a */
+  unsigned int hash = 2166136261u;
+
+  if (word == NULL)
+    return hash;
+
+  for (size_t i = 0; word[i] != '\0'; i++) {
+    hash ^= (unsigned char)word[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/* Table management */
+
+static void place_node(WordNode **slots, size_t capacity, WordNode *node) {
+  size_t mask = capacity - 1;
+  size_t i = node->hash & mask;
+
+  while (slots[i] != NULL) {
+    i = (i + 1) & mask;
+  }
+  slots[i] = node;
+}
+
+static bool grow_index(void) {
+  size_t new_capacity = g_index_capacity == 0 ? WORD_INDEX_INITIAL_CAPACITY
+                                              : g_index_capacity * 2;
+
+  WordNode **new_slots = (WordNode **)calloc(new_capacity, sizeof(WordNode *));
+  if (new_slots == NULL) {
+    fprintf(stderr, "Error: Unable to allocate memory for word index.\n");
+    return false;
+  }
+
+  for (size_t i = 0; i < g_index_capacity; i++) {
+    if (g_index_slots[i] != NULL) {
+      place_node(new_slots, new_capacity, g_index_slots[i]);
+    }
+  }
+
+  free(g_index_slots);
+  g_index_slots = new_slots;
+  g_index_capacity = new_capacity;
+  return true;
+}
+
+/* Index operations */
+
+ErrorCode word_index_insert(WordNode *node) {
+  if (node == NULL || node->clean_word == NULL) {
+    return ERROR_INVALID_INPUT;
+  }
+
+  /* Keep the load factor below 0.7 */
+  if ((g_index_count + 1) * 10 > g_index_capacity * 7 && !grow_index()) {
+    return ERROR_MEMORY_ALLOCATION;
+  }
+
+  node->hash = hash_word(node->clean_word);
+
+  size_t mask = g_index_capacity - 1;
+  size_t i = node->hash & mask;
+  while (g_index_slots[i] != NULL) {
+    if (g_index_slots[i]->hash == node->hash &&
+        same_word(g_index_slots[i], node)) {
+      return ERROR_WORD_EXISTS;
+    }
+    i = (i + 1) & mask;
+  }
+
+  g_index_slots[i] = node;
+  g_index_count++;
+  return SUCCESS;
+}
+
+void word_index_remove(const WordNode *node) {
+  if (node == NULL || g_index_capacity == 0) {
+    return;
+  }
+
+  size_t mask = g_index_capacity - 1;
+  size_t i = node->hash & mask;
+  while (g_index_slots[i] != NULL && g_index_slots[i] != node) {
+    i = (i + 1) & mask;
+  }
+
+  /* Node was never indexed */
+  if (g_index_slots[i] == NULL) {
+    return;
+  }
+
+  /* Backward-shift deletion keeps every probe chain unbroken */
+  size_t j = i;
+  while (true) {
+    j = (j + 1) & mask;
+    if (g_index_slots[j] == NULL) {
+      break;
+    }
+
+    size_t home = g_index_slots[j]->hash & mask;
+    bool home_in_gap = (i <= j) ? (i < home && home <= j)
+                                : (i < home || home <= j);
+    if (!home_in_gap) {
+      g_index_slots[i] = g_index_slots[j];
+      i = j;
+    }
+  }
+
+  g_index_slots[i] = NULL;
+  g_index_count--;
+}
+
+WordNode *word_index_find(const char *word) {
+  if (word == NULL || g_index_count == 0) {
+    return NULL;
+  }
+
+  unsigned int hash = hash_word(word);
+  size_t mask = g_index_capacity - 1;
+  size_t i = hash & mask;
+
+  while (g_index_slots[i] != NULL) {
+    if (g_index_slots[i]->hash == hash &&
+        strcmp(g_index_slots[i]->clean_word, word) == 0) {
+      return g_index_slots[i];
+    }
+    i = (i + 1) & mask;
+  }
+  return NULL;
+}
+
+void word_index_clear(void) {
+  free(g_index_slots);
+  g_index_slots = NULL;
+  g_index_capacity = 0;
+  g_index_count = 0;
+}
@@ -2,6 +2,10 @@
  * Word Node Operations
  * Memory management and node manipulation
  *
+ * Each letter list is a contiguous array of node ids sorted by word
+ * length, with the first position of every length kept alongside, so a
+ * new word's slot is found without walking the list.
+ *
  * Improvements:
  * - Better error handling in insert function
  * - Return error codes for better error tracking
@@ -9,35 +13,32 @@
  */
 
 #include "../../include/english_words.h"
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#define LETTER_LIST_INITIAL_CAPACITY 64
+
+/* Insertion counter used to order words of equal length */
+static unsigned long g_next_sequence = 0;
+
 /* Memory management */
 
 WordNode *allocate_word_node(void) {
-  WordNode *node = (WordNode *)malloc(sizeof(WordNode));
+  WordNode *node = (WordNode *)arena_alloc(sizeof(WordNode));
   if (node == NULL) {
     fprintf(stderr, "Error: Unable to allocate memory for word node.\n");
     return NULL;
   }
 
-  /* Initialize all fields to NULL/0 */
+  /* Initialize all fields to NULL/0, and every link to no word */
   memset(node, 0, sizeof(WordNode));
-
-  return node;
-}
-
-Syllable *allocate_syllable(void) {
-  Syllable *syll = (Syllable *)malloc(sizeof(Syllable));
-  if (syll == NULL) {
-    fprintf(stderr, "Error: Unable to allocate memory for syllable.\n");
-    return NULL;
+  for (int kind = 0; kind < RELATION_COUNT; kind++) {
+    node->links[kind] = NO_NODE_ID;
   }
 
-  memset(syll, 0, sizeof(Syllable));
-
-  return syll;
+  return node;
 }
 
 void free_word_node(WordNode *node) {
@@ -45,64 +46,62 @@ void free_word_node(WordNode *node) {
     return;
   }
 
-  free(node->original_word);
-  free(node->clean_word);
-  free(node->alphabetically_sorted);
-
-  /* Free syllable list */
-  Syllable *current = node->syllables;
-  while (current != NULL) {
-    Syllable *next = current->next;
-    free_syllable(current);
-    current = next;
+  if (node->clean_word != NULL) {
+    arena_free(node->clean_word, strlen(node->clean_word) + 1);
   }
+  arena_free(node->backlinks,
+             (size_t)node->backlink_capacity * sizeof(Backlink));
 
-  free(node);
+  arena_free(node, sizeof(WordNode));
 }
 
-void free_syllable(Syllable *syll) { free(syll); }
-
-void cleanup_word_lists(void) {
+void reset_word_lists(void) {
   for (int i = 0; i <= ALPHABET_SIZE; i++) {
-    WordNode *current = g_word_lists[i].head;
-    while (current != NULL) {
-      WordNode *next = current->next;
-      free_word_node(current);
-      current = next;
-    }
-    g_word_lists[i].head = NULL;
+    free(g_word_lists[i].ids);
+    memset(&g_word_lists[i], 0, sizeof(LetterList));
   }
 }
 
-/* Node initialization */
+void cleanup_word_lists(void) {
+  reset_word_lists();
 
-void initialize_word_node(WordNode *node) {
-  if (node == NULL || node->original_word == NULL) {
-    return;
-  }
+  word_index_clear();
+  node_table_clear();
+  word_columns_clear();
+  free_relationship_indexes();
+
+  /* All per-word storage lives in the arena */
+  arena_release_all();
+}
 
-  node->clean_word = remove_slashes(node->original_word);
+/* Node initialization */
+
+static bool apply_word_analysis(WordNode *node, const WordAnalysis *analysis) {
+  node->clean_word = arena_copy_string(analysis->clean_word);
   if (node->clean_word == NULL) {
     fprintf(stderr, "Error: Failed to create clean word\n");
-    return;
+    return false;
   }
 
-  node->char_count = count_characters(node->clean_word);
-  node->consonant_count = count_consonants(node->clean_word);
-  node->vowel_count = count_vowels(node->clean_word);
-  node->syllable_count = count_syllables(node->original_word);
-  node->syllables = parse_syllables(node->original_word);
-  node->is_alphabetically_ordered =
-      is_word_alphabetically_ordered(node->clean_word);
-  node->alphabetically_sorted = sort_word_alphabetically(node->clean_word);
-
-  if (node->alphabetically_sorted == NULL) {
-    fprintf(stderr, "Error: Failed to create sorted word\n");
-  }
+  node->syllable_breaks = analysis->syllable_breaks;
+  /* Counts are below MAX_WORD_LENGTH, so they fit in a byte */
+  node->char_count = (unsigned char)analysis->char_count;
+  node->consonant_count = (unsigned char)analysis->consonant_count;
+  node->vowel_count = (unsigned char)analysis->vowel_count;
+  node->is_alphabetically_ordered = analysis->is_alphabetically_ordered;
+  node->letter_mask = analysis->letter_mask;
+  memcpy(node->letter_counts, analysis->letter_counts, ALPHABET_SIZE);
+  pack_word(node->clean_word, &node->packed);
+  return true;
 }
 
 /* Display operations */
 
+static const char *linked_word_text(const WordNode *node, RelationKind kind) {
+  const WordNode *target = linked_word(node, kind);
+  return target != NULL ? target->clean_word : "none";
+}
+
 void print_word_details(const WordNode *node) {
   if (node == NULL) {
     printf("Error: NULL word node\n");
@@ -115,156 +114,331 @@ void print_word_details(const WordNode *node) {
   printf("Character count:           %d\n", node->char_count);
   printf("Consonant count:           %d\n", node->consonant_count);
   printf("Vowel count:               %d\n", node->vowel_count);
-  printf("Syllable count:            %d\n", node->syllable_count);
+  printf("Syllable count:            %d\n", get_syllable_count(node));
   printf("Syllables:                 ");
-  print_syllable_list(node->syllables);
+  print_syllables(node);
   printf("\n");
   printf("Alphabetically ordered:    %s\n",
          node->is_alphabetically_ordered ? "yes" : "no");
-  printf("Alphabetically sorted:     %s\n",
-         node->alphabetically_sorted ? node->alphabetically_sorted : "(null)");
+
+  char sorted[MAX_WORD_LENGTH];
+  format_sorted_word(node, sorted);
+  printf("Alphabetically sorted:     %s\n", sorted);
 
   /* Print relationships */
   printf("\nRelationships:\n");
   printf("  Subword of:              %s\n",
-         node->subword_of ? node->subword_of->clean_word : "none");
+         linked_word_text(node, RELATION_SUBWORD));
   printf("  Gerund form (-ing):      %s\n",
-         node->ing_form ? node->ing_form->clean_word : "none");
+         linked_word_text(node, RELATION_ING_FORM));
   printf("  Past participle (-ed):   %s\n",
-         node->ed_form ? node->ed_form->clean_word : "none");
+         linked_word_text(node, RELATION_ED_FORM));
+  printf("  Plural/3rd person (-s):  %s\n",
+         linked_word_text(node, RELATION_S_FORM));
+  printf("  -er form:                %s\n",
+         linked_word_text(node, RELATION_ER_FORM));
+  printf("  -est form:               %s\n",
+         linked_word_text(node, RELATION_EST_FORM));
   printf("  Add one character:       %s\n",
-         node->add_one_char ? node->add_one_char->clean_word : "none");
+         linked_word_text(node, RELATION_ADD_ONE_CHAR));
   printf("  Lexically close to:      %s\n",
-         node->lexically_close ? node->lexically_close->clean_word : "none");
-  printf("  Anagram:                 %s\n",
-         node->anagram ? node->anagram->clean_word : "none");
+         linked_word_text(node, RELATION_LEXICALLY_CLOSE));
+  printf("  Anagrams:                ");
+  bool has_anagram = false;
+  if (node->anagram_class != NULL) {
+    for (int i = 0; i < node->anagram_class->count; i++) {
+      const WordNode *member = node->anagram_class->nodes[i];
+      if (member != node) {
+        printf("%s%s", has_anagram ? ", " : "", member->clean_word);
+        has_anagram = true;
+      }
+    }
+  }
+  printf("%s\n", has_anagram ? "" : "none");
+}
+
+/* Derived views */
+
+int get_syllable_count(const WordNode *node) {
+  return count_bits(node->syllable_breaks) + 1;
+}
+
+/* Length of the word as written, with one slash per syllable break */
+size_t get_original_length(const WordNode *node) {
+  return (size_t)node->char_count + (size_t)count_bits(node->syllable_breaks);
+}
+
+/* Write the word with its slashes; buffer holds MAX_WORD_LENGTH chars */
+size_t format_original_word(const WordNode *node, char *buffer) {
+  size_t length = 0;
+  for (size_t i = 0; node->clean_word[i] != '\0'; i++) {
+    if ((node->syllable_breaks >> i) & 1) {
+      buffer[length++] = '/';
+    }
+    buffer[length++] = node->clean_word[i];
+  }
+  buffer[length] = '\0';
+  return length;
+}
+
+void format_sorted_word(const WordNode *node, char *buffer) {
+  sort_letters(node->clean_word, node->letter_counts, buffer);
+}
+
+void print_syllables(const WordNode *node) {
+  for (size_t i = 0; node->clean_word[i] != '\0'; i++) {
+    if ((node->syllable_breaks >> i) & 1) {
+      printf(" / ");
+    }
+    putchar(node->clean_word[i]);
+  }
+}
+
+/* Letter list storage */
+
+static bool reserve_list_slot(LetterList *list) {
+  if (list->count < list->capacity) {
+    return true;
+  }
+
+  int new_capacity =
+      list->capacity == 0 ? LETTER_LIST_INITIAL_CAPACITY : list->capacity * 2;
+  unsigned int *new_ids = (unsigned int *)realloc(
+      list->ids, (size_t)new_capacity * sizeof(unsigned int));
+  if (new_ids == NULL) {
+    fprintf(stderr, "Error: Unable to allocate memory for word list.\n");
+    return false;
+  }
+
+  list->ids = new_ids;
+  list->capacity = new_capacity;
+  return true;
+}
+
+static ErrorCode add_to_letter_list(LetterList *list, const WordNode *node) {
+  size_t length = get_original_length(node);
+  if (length >= MAX_WORD_LENGTH) {
+    return ERROR_INVALID_INPUT;
+  }
+
+  if (!reserve_list_slot(list)) {
+    return ERROR_MEMORY_ALLOCATION;
+  }
+
+  /* A new word goes after every word of the same length */
+  int position = list->length_start[length + 1];
+  memmove(&list->ids[position + 1], &list->ids[position],
+          (size_t)(list->count - position) * sizeof(unsigned int));
+  list->ids[position] = node->id;
+  list->count++;
+
+  for (size_t l = length + 1; l <= MAX_WORD_LENGTH; l++) {
+    list->length_start[l]++;
+  }
+  return SUCCESS;
+}
+
+/* Position of node in list, or -1 when it is not stored there */
+static int find_list_position(const LetterList *list, const WordNode *node) {
+  size_t length = get_original_length(node);
+  if (length >= MAX_WORD_LENGTH) {
+    return -1;
+  }
+
+  /* Words of one length are stored in insertion order */
+  int low = list->length_start[length];
+  int end = list->length_start[length + 1];
+  int high = end;
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (word_node_at(list->ids[mid])->sequence < node->sequence) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  return low < end && list->ids[low] == node->id ? low : -1;
+}
+
+static void remove_list_position(LetterList *list, int position,
+                                 size_t length) {
+  memmove(&list->ids[position], &list->ids[position + 1],
+          (size_t)(list->count - position - 1) * sizeof(unsigned int));
+  list->count--;
+
+  for (size_t l = length + 1; l <= MAX_WORD_LENGTH; l++) {
+    list->length_start[l]--;
+  }
 }
 
 /* List operations */
 
-ErrorCode insert_word_sorted_by_length(WordNode **head, const char *word) {
-  if (head == NULL || word == NULL) {
+ErrorCode insert_word_sorted_by_length(LetterList *list, const char *word) {
+  if (word == NULL) {
+    return ERROR_INVALID_INPUT;
+  }
+
+  return insert_word_span(list, word, strlen(word));
+}
+
+ErrorCode insert_word_span(LetterList *list, const char *word, size_t length) {
+  if (list == NULL || word == NULL || length >= MAX_WORD_LENGTH) {
     return ERROR_INVALID_INPUT;
   }
 
-  if (!is_valid_word_format(word)) {
+  char buffer[MAX_WORD_LENGTH];
+  memcpy(buffer, word, length);
+  buffer[length] = '\0';
+
+  if (!is_valid_word_format(buffer)) {
     return ERROR_INVALID_INPUT;
   }
 
-  WordNode *new_node = allocate_word_node();
-  if (new_node == NULL) {
+  WordAnalysis analysis;
+  if (!analyze_word(buffer, &analysis)) {
     return ERROR_MEMORY_ALLOCATION;
   }
 
-  new_node->original_word = (char *)malloc(strlen(word) + 1);
-  if (new_node->original_word == NULL) {
-    free_word_node(new_node);
+  return insert_analyzed_word(list, &analysis);
+}
+
+/*
+ * Insert a word from its analysis alone. The caller has already checked
+ * the word with is_valid_word_format (or the same checks on its character
+ * classes) before analyzing it, so the word is not validated again here.
+ */
+ErrorCode insert_analyzed_word(LetterList *list, const WordAnalysis *analysis) {
+  if (list == NULL || analysis == NULL) {
+    return ERROR_INVALID_INPUT;
+  }
+
+  /* Duplicates are rejected by the word index before anything is built */
+  if (word_index_find(analysis->clean_word) != NULL) {
+    return ERROR_WORD_EXISTS;
+  }
+
+  WordNode *new_node = allocate_word_node();
+  if (new_node == NULL) {
     return ERROR_MEMORY_ALLOCATION;
   }
 
-  strcpy(new_node->original_word, word);
-  initialize_word_node(new_node);
+  new_node->sequence = g_next_sequence++;
 
-  /* Check if initialization succeeded */
-  if (new_node->clean_word == NULL) {
+  if (!apply_word_analysis(new_node, analysis)) {
     free_word_node(new_node);
     return ERROR_MEMORY_ALLOCATION;
   }
 
-  /* Empty list case */
-  if (*head == NULL) {
-    *head = new_node;
-    return SUCCESS;
+  /* Register in the word index */
+  ErrorCode result = word_index_insert(new_node);
+  if (result != SUCCESS) {
+    free_word_node(new_node);
+    return result;
   }
 
-  /* Insert at beginning if shorter than head */
-  if (strlen(new_node->original_word) < strlen((*head)->original_word)) {
-    new_node->next = *head;
-    (*head)->prev = new_node;
-    *head = new_node;
-    return SUCCESS;
+  result = node_table_add(new_node);
+  if (result == SUCCESS) {
+    result = add_to_letter_list(list, new_node);
+    if (result != SUCCESS) {
+      node_table_remove(new_node);
+    }
   }
 
-  /* Find insertion position */
-  WordNode *current = *head;
-  while (current->next != NULL && strlen(new_node->original_word) >=
-                                      strlen(current->next->original_word)) {
-    current = current->next;
+  if (result != SUCCESS) {
+    word_index_remove(new_node);
+    free_word_node(new_node);
   }
+  return result;
+}
 
-  /* Insert after current */
-  new_node->prev = current;
-  new_node->next = current->next;
-
-  if (current->next != NULL) {
-    current->next->prev = new_node;
+/* Add an initialized node; nodes supplied in list order are appended */
+ErrorCode append_word_node(LetterList *list, WordNode *node) {
+  if (list == NULL || node == NULL) {
+    return ERROR_INVALID_INPUT;
   }
 
-  current->next = new_node;
-  return SUCCESS;
-}
+  node->sequence = g_next_sequence++;
 
-bool delete_word_from_list(WordNode **head, const char *word) {
-  if (head == NULL || *head == NULL || word == NULL) {
-    return false;
+  /* A repeated word is an error: it would be a second node for one key */
+  ErrorCode result = word_index_insert(node);
+  if (result != SUCCESS) {
+    return result;
   }
 
-  WordNode *current = *head;
-  while (current != NULL && strcmp(current->clean_word, word) != 0) {
-    current = current->next;
+  result = node_table_add(node);
+  if (result == SUCCESS) {
+    result = add_to_letter_list(list, node);
+    if (result != SUCCESS) {
+      node_table_remove(node);
+    }
   }
 
-  if (current == NULL) {
-    return false;
+  if (result != SUCCESS) {
+    word_index_remove(node);
   }
+  return result;
+}
 
-  /* Update head if deleting first node */
-  if (*head == current) {
-    *head = current->next;
+bool delete_word_from_list(LetterList *list, const char *word) {
+  if (list == NULL || list->count == 0 || word == NULL) {
+    return false;
   }
 
-  /* Update links */
-  if (current->next != NULL) {
-    current->next->prev = current->prev;
+  WordNode *current = word_index_find(word);
+  if (current == NULL) {
+    return false;
   }
 
-  if (current->prev != NULL) {
-    current->prev->next = current->next;
+  /* The word must be stored in this list */
+  int position = find_list_position(list, current);
+  if (position < 0) {
+    return false;
   }
 
+  remove_list_position(list, position, get_original_length(current));
+  node_table_remove(current);
+  word_index_remove(current);
   free_word_node(current);
   return true;
 }
 
-WordNode *search_word(const WordNode *head, const char *word) {
-  if (word == NULL)
-    return NULL;
+WordNode *search_word(const char *word) { return word_index_find(word); }
 
-  const WordNode *current = head;
-  while (current != NULL) {
-    if (current->clean_word && strcmp(current->clean_word, word) == 0) {
-      return (WordNode *)current;
-    }
-    current = current->next;
+int compare_word_order(const WordNode *a, const WordNode *b) {
+  /* Same order as a traversal of lists A-Z, each sorted by length */
+  int index_a = toupper((unsigned char)a->clean_word[0]);
+  int index_b = toupper((unsigned char)b->clean_word[0]);
+  if (index_a != index_b) {
+    return index_a < index_b ? -1 : 1;
+  }
+
+  size_t length_a = get_original_length(a);
+  size_t length_b = get_original_length(b);
+  if (length_a != length_b) {
+    return length_a < length_b ? -1 : 1;
   }
-  return NULL;
+
+  if (a->sequence != b->sequence) {
+    return a->sequence < b->sequence ? -1 : 1;
+  }
+  return 0;
 }
 
-void print_word_list(const WordNode *head) {
-  if (head == NULL) {
+void print_word_list(const LetterList *list) {
+  if (list == NULL || list->count == 0) {
     printf("(empty)\n");
     return;
   }
 
-  const WordNode *current = head;
-  while (current != NULL) {
+  for (int pos = 0; pos < list->count; pos++) {
+    const WordNode *current = word_node_at(list->ids[pos]);
     if (current->clean_word) {
       printf("%s", current->clean_word);
-      if (current->next != NULL) {
+      if (pos + 1 < list->count) {
         printf(" - ");
       }
     }
-    current = current->next;
   }
   printf("\n");
 }
@@ -273,39 +447,9 @@ void print_all_word_lists(void) {
   printf("\n=== Word Lists ===\n\n");
 
   for (int i = 0; i < ALPHABET_SIZE; i++) {
-    if (g_word_lists[i].head != NULL) {
+    if (g_word_lists[i].count > 0) {
       printf("[%c]: ", 'A' + i);
-      print_word_list(g_word_lists[i].head);
+      print_word_list(&g_word_lists[i]);
     }
   }
 }
-
-void remove_duplicate_words(void) {
-  for (int i = 0; i <= ALPHABET_SIZE; i++) {
-    WordNode *current = g_word_lists[i].head;
-
-    while (current != NULL) {
-      WordNode *checker = current->next;
-
-      while (checker != NULL) {
-        WordNode *next = checker->next;
-
-        if (current->clean_word && checker->clean_word &&
-            strcmp(current->clean_word, checker->clean_word) == 0) {
-          /* Remove duplicate */
-          if (checker->prev != NULL) {
-            checker->prev->next = checker->next;
-          }
-          if (checker->next != NULL) {
-            checker->next->prev = checker->prev;
-          }
-          free_word_node(checker);
-        }
-
-        checker = next;
-      }
-
-      current = current->next;
-    }
-  }
-}
\ No newline at end of file
@@ -15,20 +15,22 @@
 
 void print_subword_chains(void) {
   for (int i = 0; i < ALPHABET_SIZE; i++) {
-    WordNode *current = g_word_lists[i].head;
+    const LetterList *list = &g_word_lists[i];
 
-    while (current != NULL) {
-      if (current->subword_of != NULL) {
+    for (int pos = 0; pos < list->count; pos++) {
+      WordNode *current = word_node_at(list->ids[pos]);
+      WordNode *superword = linked_word(current, RELATION_SUBWORD);
+      if (superword != NULL) {
         printf("%s --> ", current->clean_word);
-        printf("%s", current->subword_of->clean_word);
+        printf("%s", superword->clean_word);
 
         /* Follow the chain with loop detection */
-        WordNode *chain = current->subword_of->subword_of;
+        WordNode *chain = linked_word(superword, RELATION_SUBWORD);
         WordNode *visited[MAX_CHAIN_LENGTH];
         int visited_count = 0;
 
         visited[visited_count++] = current;
-        visited[visited_count++] = current->subword_of;
+        visited[visited_count++] = superword;
 
         while (chain != NULL && visited_count < MAX_CHAIN_LENGTH) {
           /* Check if we've seen this node before */
@@ -47,59 +49,101 @@ void print_subword_chains(void) {
 
           printf(" --> %s", chain->clean_word);
           visited[visited_count++] = chain;
-          chain = chain->subword_of;
+          chain = linked_word(chain, RELATION_SUBWORD);
         }
 
         printf(" --> (end)\n");
       }
-      current = current->next;
     }
   }
 }
 
 void print_verb_forms(void) {
   for (int i = 0; i < ALPHABET_SIZE; i++) {
-    WordNode *current = g_word_lists[i].head;
+    const LetterList *list = &g_word_lists[i];
 
-    while (current != NULL) {
-      if (current->ed_form != NULL || current->ing_form != NULL) {
+    for (int pos = 0; pos < list->count; pos++) {
+      WordNode *current = word_node_at(list->ids[pos]);
+      const WordNode *ed_form = linked_word(current, RELATION_ED_FORM);
+      const WordNode *ing_form = linked_word(current, RELATION_ING_FORM);
+      if (ed_form != NULL || ing_form != NULL) {
         printf("%s --> ", current->clean_word);
 
-        if (current->ed_form != NULL) {
-          printf("%s", current->ed_form->clean_word);
+        if (ed_form != NULL) {
+          printf("%s", ed_form->clean_word);
         } else {
           printf("(no -ed form)");
         }
 
         printf(" --> ");
 
-        if (current->ing_form != NULL) {
-          printf("%s\n", current->ing_form->clean_word);
+        if (ing_form != NULL) {
+          printf("%s\n", ing_form->clean_word);
         } else {
           printf("(no -ing form)\n");
         }
       }
-      current = current->next;
     }
   }
 }
 
-void print_lexically_close_words(void) {
+void print_inflections(void) {
+  static const Inflection inflections[] = {INFLECTION_S, INFLECTION_ER,
+                                           INFLECTION_EST};
+  static const char *const labels[] = {"-s", "-er", "-est"};
+  const int count = (int)(sizeof(inflections) / sizeof(inflections[0]));
+
   for (int i = 0; i < ALPHABET_SIZE; i++) {
-    WordNode *current = g_word_lists[i].head;
+    const LetterList *list = &g_word_lists[i];
+
+    for (int pos = 0; pos < list->count; pos++) {
+      WordNode *current = word_node_at(list->ids[pos]);
+      int printed = 0;
+
+      for (int k = 0; k < count; k++) {
+        const WordNode *form =
+            linked_word(current, inflection_relation(inflections[k]));
+        if (form == NULL) {
+          continue;
+        }
 
-    while (current != NULL) {
-      if (current->lexically_close != NULL) {
+        if (printed == 0) {
+          printf("%s --> ", current->clean_word);
+        } else {
+          printf(", ");
+        }
+        printf("%s: %s", labels[k], form->clean_word);
+        printed++;
+      }
+
+      if (printed > 0) {
+        printf("\n");
+      }
+    }
+  }
+}
+
+void print_add_one_char_chains(void) {
+  for (int i = 0; i < ALPHABET_SIZE; i++) {
+    const LetterList *list = &g_word_lists[i];
+
+    for (int pos = 0; pos < list->count; pos++) {
+      WordNode *current = word_node_at(list->ids[pos]);
+      WordNode *longer = linked_word(current, RELATION_ADD_ONE_CHAR);
+      if (longer != NULL) {
         printf("%s --> ", current->clean_word);
+        printf("%s", longer->clean_word);
 
-        WordNode *chain = current->lexically_close;
+        /* Follow the chain with loop detection */
+        WordNode *chain = linked_word(longer, RELATION_ADD_ONE_CHAR);
         WordNode *visited[MAX_CHAIN_LENGTH];
         int visited_count = 0;
 
         visited[visited_count++] = current;
+        visited[visited_count++] = longer;
 
         while (chain != NULL && visited_count < MAX_CHAIN_LENGTH) {
-          /* Check if we've seen this node before (circular detection) */
+          /* Check if we've seen this node before */
           bool is_loop = false;
           for (int j = 0; j < visited_count; j++) {
             if (visited[j] == chain) {
@@ -109,30 +153,31 @@ void print_lexically_close_words(void) {
           }
 
           if (is_loop) {
+            printf(" --> (loop detected)");
             break;
           }
 
-          printf("%s --> ", chain->clean_word);
+          printf(" --> %s", chain->clean_word);
           visited[visited_count++] = chain;
-          chain = chain->lexically_close;
+          chain = linked_word(chain, RELATION_ADD_ONE_CHAR);
         }
 
-        printf("(end)\n");
+        printf(" --> (end)\n");
       }
-      current = current->next;
     }
   }
 }
 
-void print_anagrams(void) {
+void print_lexically_close_words(void) {
   for (int i = 0; i < ALPHABET_SIZE; i++) {
-    WordNode *current = g_word_lists[i].head;
+    const LetterList *list = &g_word_lists[i];
 
-    while (current != NULL) {
-      if (current->anagram != NULL) {
+    for (int pos = 0; pos < list->count; pos++) {
+      WordNode *current = word_node_at(list->ids[pos]);
+      WordNode *chain = linked_word(current, RELATION_LEXICALLY_CLOSE);
+      if (chain != NULL) {
         printf("%s --> ", current->clean_word);
 
-        WordNode *chain = current->anagram;
         WordNode *visited[MAX_CHAIN_LENGTH];
         int visited_count = 0;
 
@@ -154,12 +199,30 @@ void print_anagrams(void) {
 
           printf("%s --> ", chain->clean_word);
           visited[visited_count++] = chain;
-          chain = chain->anagram;
+          chain = linked_word(chain, RELATION_LEXICALLY_CLOSE);
         }
 
         printf("(end)\n");
       }
-      current = current->next;
+    }
+  }
+}
+
+void print_anagrams(void) {
+  for (int i = 0; i < ALPHABET_SIZE; i++) {
+    const LetterList *list = &g_word_lists[i];
+
+    for (int pos = 0; pos < list->count; pos++) {
+      WordNode *current = word_node_at(list->ids[pos]);
+      const WordBucket *class = current->anagram_class;
+
+      /* Print each class once, starting from its first member */
+      if (class != NULL && class->count > 1 && class->nodes[0] == current) {
+        for (int k = 0; k < class->count; k++) {
+          printf("%s --> ", class->nodes[k]->clean_word);
+        }
+        printf("(end)\n");
+      }
     }
   }
 }
\ No newline at end of file
@@ -1,178 +1,670 @@
 /**
  * File Input/Output Operations
- * Reading words from files
+ * Reading words from files and persisting edits
+ *
+ * The words file is memory-mapped and tokenized in place, so loading has
+ * no word count limit and no per-line copies. The buffer is split into
+ * whitespace-aligned chunks that worker threads tokenize, validate and
+ * analyze in parallel; the results are then inserted in file order, so
+ * the dictionary is identical to a single-threaded load.
  */
 
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include "../../include/english_words.h"
 #include <ctype.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #define WORDS_FILE_PATH "persistence/words.txt"
+#define JOURNAL_FILE_PATH "persistence/words.journal"
+#define JOURNAL_WRITE_BUFFER_SIZE (64 * 1024)
+
+#define LOAD_CHUNK_SIZE (256 * 1024)
+#define LOAD_MAX_THREADS 16
+#define LOAD_TOKENS_INITIAL_CAPACITY 1024
 
 /* Global word lists definition */
 LetterList g_word_lists[ALPHABET_SIZE + 1];
 
-static int read_words_to_array(const char *filename,
-                               char words[][MAX_WORD_LENGTH]) {
-  if (filename == NULL) {
-    return -1;
-  }
+/* File mapping */
+
+/*
+ * A whole file is mapped read-only (the words file is tokenized in place,
+ * snapshots are read directly); on platforms without mmap it is read into
+ * a single buffer instead.
+ */
+const char *map_file(const char *filename, size_t *size) {
+  *size = 0;
 
-  FILE *file = fopen(filename, "r");
+#ifdef _WIN32
+  FILE *file = fopen(filename, "rb");
   if (file == NULL) {
-    return -1;
+    return NULL;
+  }
+
+  fseek(file, 0, SEEK_END);
+  long file_size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  if (file_size < 0) {
+    fclose(file);
+    return NULL;
+  }
+
+  char *data = (char *)malloc((size_t)file_size + 1);
+  if (data == NULL) {
+    fclose(file);
+    return NULL;
+  }
+
+  *size = fread(data, 1, (size_t)file_size, file);
+  fclose(file);
+  return data;
+#else
+  int fd = open(filename, O_RDONLY);
+  if (fd == -1) {
+    return NULL;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) == -1) {
+    close(fd);
+    return NULL;
+  }
+
+  /* An empty file maps to an empty (but valid) buffer */
+  if (info.st_size == 0) {
+    close(fd);
+    return "";
+  }
+
+  void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return NULL;
   }
 
-  int count = 0;
-  char buffer[512];
+  posix_madvise(data, (size_t)info.st_size, POSIX_MADV_SEQUENTIAL);
+  *size = (size_t)info.st_size;
+  return (const char *)data;
+#endif
+}
+
+void unmap_file(const char *data, size_t size) {
+#ifdef _WIN32
+  (void)size;
+  free((void *)data);
+#else
+  if (size > 0) {
+    munmap((void *)data, size);
+  }
+#endif
+}
+
+/* Parallel parsing */
+
+typedef enum {
+  TOKEN_VALID,
+  TOKEN_TOO_LONG,
+  TOKEN_INVALID_CHARACTERS,
+  TOKEN_REJECTED /* Passed the character check but cannot be inserted */
+} TokenStatus;
+
+typedef struct {
+  const char *text;
+  size_t length;
+  TokenStatus status;
+  ErrorCode error;
+  WordAnalysis analysis;
+} ParsedToken;
+
+typedef struct {
+  const char *start;
+  const char *end;
+  ParsedToken *tokens;
+  size_t count;
+  size_t capacity;
+  bool failed;
+} LoadChunk;
+
+static bool is_word_delimiter(char c) { return isspace((unsigned char)c); }
+
+static int get_token_letter_index(const char *token) {
+  if (!isalpha((unsigned char)token[0])) {
+    return INVALID_LIST_INDEX;
+  }
+  return toupper((unsigned char)token[0]) - 'A';
+}
+
+/* Validate and analyze one token; touches nothing but the token record */
+static void parse_token(ParsedToken *token) {
+  token->error = SUCCESS;
+
+  if (token->length >= MAX_WORD_LENGTH) {
+    token->status = TOKEN_TOO_LONG;
+    return;
+  }
+
+  CharClasses classes;
+  classify_characters(token->text, token->length, &classes);
+  if (count_bits(classes.letters | classes.slashes) != (int)token->length) {
+    token->status = TOKEN_INVALID_CHARACTERS;
+    return;
+  }
+
+  /* Slash placement, from the same classification */
+  if (!is_valid_word_classes(&classes, token->length)) {
+    token->status = TOKEN_REJECTED;
+    token->error = ERROR_INVALID_INPUT;
+    return;
+  }
+
+  char word[MAX_WORD_LENGTH];
+  memcpy(word, token->text, token->length);
+  word[token->length] = '\0';
+
+  if (!analyze_word(word, &token->analysis)) {
+    token->status = TOKEN_REJECTED;
+    token->error = ERROR_MEMORY_ALLOCATION;
+    return;
+  }
+
+  token->status = TOKEN_VALID;
+}
 
-  while (count < MAX_WORDS && fgets(buffer, sizeof(buffer), file) != NULL) {
-    /* Remove trailing whitespace */
-    size_t len = strlen(buffer);
-    while (len > 0 && isspace((unsigned char)buffer[len - 1])) {
-      buffer[--len] = '\0';
+static bool append_token(LoadChunk *chunk, const char *text, size_t length) {
+  if (chunk->count == chunk->capacity) {
+    size_t new_capacity = chunk->capacity == 0 ? LOAD_TOKENS_INITIAL_CAPACITY
+                                               : chunk->capacity * 2;
+    ParsedToken *new_tokens = (ParsedToken *)realloc(
+        chunk->tokens, new_capacity * sizeof(ParsedToken));
+    if (new_tokens == NULL) {
+      return false;
     }
+    chunk->tokens = new_tokens;
+    chunk->capacity = new_capacity;
+  }
 
-    /* Parse multiple words from the line */
-    char *token = strtok(buffer, " \t\n\r");
+  ParsedToken *token = &chunk->tokens[chunk->count++];
+  token->text = text;
+  token->length = length;
+  parse_token(token);
+  return true;
+}
 
-    while (token != NULL && count < MAX_WORDS) {
-      len = strlen(token);
+/* Worker entry point: tokenize and analyze one chunk */
+static void *parse_chunk(void *arg) {
+  LoadChunk *chunk = (LoadChunk *)arg;
+  const char *pos = chunk->start;
 
-      /* Check if word fits and is valid */
-      if (len > 0 && len < MAX_WORD_LENGTH) {
-        /* Validate word format before adding */
-        bool valid = true;
-        for (size_t i = 0; i < len; i++) {
-          if (!isalpha((unsigned char)token[i]) && token[i] != '/') {
-            valid = false;
-            break;
-          }
-        }
+  while (pos < chunk->end) {
+    while (pos < chunk->end && is_word_delimiter(*pos)) {
+      pos++;
+    }
 
-        if (valid) {
-          strncpy(words[count], token, MAX_WORD_LENGTH - 1);
-          words[count][MAX_WORD_LENGTH - 1] = '\0';
-          count++;
-        } else {
-          fprintf(stderr, "Warning: Invalid word format, skipping: %s\n",
-                  token);
-        }
-      } else if (len >= MAX_WORD_LENGTH) {
-        fprintf(stderr, "Warning: Word too long, skipping: %.20s...\n", token);
-      }
+    const char *start = pos;
+    while (pos < chunk->end && !is_word_delimiter(*pos)) {
+      pos++;
+    }
 
-      token = strtok(NULL, " \t\n\r");
+    if (pos > start && !append_token(chunk, start, (size_t)(pos - start))) {
+      chunk->failed = true;
+      break;
     }
   }
 
-  fclose(file);
-  return count;
+  return NULL;
 }
 
-static void insert_words_into_lists(char words[][MAX_WORD_LENGTH], int count) {
-  /* Initialize all lists to NULL */
-  for (int i = 0; i <= ALPHABET_SIZE; i++) {
-    g_word_lists[i].head = NULL;
-  }
-
-  /* Insert each word into appropriate list */
-  for (int i = 0; i < count; i++) {
-    int index = get_word_letter_index(words[i]);
-    if (index >= 0 && index <= ALPHABET_SIZE) {
-      ErrorCode result =
-          insert_word_sorted_by_length(&g_word_lists[index].head, words[i]);
-      if (result != SUCCESS) {
-        fprintf(stderr, "Warning: Failed to insert word: %s (error code: %d)\n",
-                words[i], result);
-      }
+static int get_load_thread_count(void) {
+#ifdef _WIN32
+  return 1;
+#else
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  if (cores < 1) {
+    return 1;
+  }
+  return cores > LOAD_MAX_THREADS ? LOAD_MAX_THREADS : (int)cores;
+#endif
+}
+
+/* Parse a batch of chunks, one worker thread per chunk */
+static void parse_chunks(LoadChunk *chunks, int chunk_count) {
+#ifdef _WIN32
+  for (int i = 0; i < chunk_count; i++) {
+    parse_chunk(&chunks[i]);
+  }
+#else
+  pthread_t threads[LOAD_MAX_THREADS];
+  bool started[LOAD_MAX_THREADS];
+
+  /* The first chunk is parsed on the calling thread */
+  for (int i = 1; i < chunk_count; i++) {
+    started[i] = pthread_create(&threads[i], NULL, parse_chunk, &chunks[i]) == 0;
+  }
+
+  parse_chunk(&chunks[0]);
+
+  for (int i = 1; i < chunk_count; i++) {
+    if (started[i]) {
+      pthread_join(threads[i], NULL);
+    } else {
+      parse_chunk(&chunks[i]);
     }
   }
+#endif
 }
 
-int load_words_from_file(const char *filename) {
-  if (filename == NULL) {
+/* Merge */
+
+/* Report and insert one parsed token; returns the insertion result */
+static ErrorCode merge_token(const ParsedToken *token) {
+  switch (token->status) {
+  case TOKEN_TOO_LONG:
+    fprintf(stderr, "Warning: Word too long, skipping: %.20s...\n",
+            token->text);
+    return ERROR_INVALID_INPUT;
+
+  case TOKEN_INVALID_CHARACTERS:
+    fprintf(stderr, "Warning: Invalid word format, skipping: %.*s\n",
+            (int)token->length, token->text);
+    return ERROR_INVALID_INPUT;
+
+  case TOKEN_REJECTED:
+    fprintf(stderr, "Warning: Failed to insert word: %.*s (error code: %d)\n",
+            (int)token->length, token->text, token->error);
+    return token->error;
+
+  case TOKEN_VALID:
+    break;
+  }
+
+  int index = get_token_letter_index(token->text);
+  ErrorCode result =
+      insert_analyzed_word(&g_word_lists[index], &token->analysis);
+
+  /* Repeated words are expected and only counted */
+  if (result != SUCCESS && result != ERROR_WORD_EXISTS) {
+    fprintf(stderr, "Warning: Failed to insert word: %.*s (error code: %d)\n",
+            (int)token->length, token->text, result);
+  }
+
+  return result;
+}
+
+/* Loading */
+
+int load_words_from_file(const char *filename, int *duplicates) {
+  if (filename == NULL || duplicates == NULL) {
     return -1;
   }
 
-  char words[MAX_WORDS][MAX_WORD_LENGTH];
+  *duplicates = 0;
 
-  int word_count = read_words_to_array(filename, words);
-  if (word_count == -1) {
+  size_t size;
+  const char *data = map_file(filename, &size);
+  if (data == NULL) {
     return -1;
   }
 
+  /* Start from empty lists */
+  reset_word_lists();
+
+  int thread_count = get_load_thread_count();
+  LoadChunk chunks[LOAD_MAX_THREADS];
+  memset(chunks, 0, sizeof(chunks));
+
+  int word_count = 0;
+  size_t pos = 0;
+  bool failed = false;
+
+  while (pos < size && !failed) {
+    /* Cut the next batch of chunks at word boundaries */
+    int chunk_count = 0;
+    while (pos < size && chunk_count < thread_count) {
+      size_t end = size - pos > LOAD_CHUNK_SIZE ? pos + LOAD_CHUNK_SIZE : size;
+      while (end < size && !is_word_delimiter(data[end])) {
+        end++;
+      }
+
+      LoadChunk *chunk = &chunks[chunk_count++];
+      chunk->start = data + pos;
+      chunk->end = data + end;
+      chunk->count = 0;
+      chunk->failed = false;
+      pos = end;
+    }
+
+    parse_chunks(chunks, chunk_count);
+
+    /* Insert in file order so the result matches a sequential load */
+    for (int i = 0; i < chunk_count && !failed; i++) {
+      for (size_t t = 0; t < chunks[i].count; t++) {
+        ErrorCode result = merge_token(&chunks[i].tokens[t]);
+        if (result == SUCCESS) {
+          word_count++;
+        } else if (result == ERROR_WORD_EXISTS) {
+          (*duplicates)++;
+        }
+      }
+
+      if (chunks[i].failed) {
+        fprintf(stderr, "Error: Unable to allocate memory while loading.\n");
+        failed = true;
+      }
+    }
+  }
+
+  for (int i = 0; i < thread_count; i++) {
+    free(chunks[i].tokens);
+  }
+
+  unmap_file(data, size);
+
   if (word_count == 0) {
     fprintf(stderr, "Warning: No words loaded from file\n");
-    return 0;
   }
 
-  insert_words_into_lists(words, word_count);
-
   return word_count;
 }
 
-bool save_word_to_file(const char *word) {
+/* Edit journal */
+
+/*
+ * Edits are appended to the journal as one line each ("+word" for an
+ * insertion, "-word" for a deletion) instead of rewriting words.txt.
+ * The journal is replayed after loading and folded back into the words
+ * file by compaction.
+ */
+bool append_journal_record(JournalOperation operation, const char *word) {
   if (word == NULL || word[0] == '\0') {
     return false;
   }
 
-  FILE *file = fopen(WORDS_FILE_PATH, "a");
+  FILE *file = fopen(JOURNAL_FILE_PATH, "a");
+  if (file == NULL) {
+    perror("Error opening journal for append");
+    return false;
+  }
+
+  bool written = fprintf(file, "%c%s\n", (char)operation, word) > 0;
+  return fclose(file) == 0 && written;
+}
+
+/* Append many records with one open and one buffered write */
+bool append_journal_records(JournalOperation operation,
+                            const char *const *words, size_t count) {
+  if (words == NULL) {
+    return false;
+  }
+
+  FILE *file = fopen(JOURNAL_FILE_PATH, "a");
   if (file == NULL) {
-    perror("Error opening file for append");
+    perror("Error opening journal for append");
     return false;
   }
 
-  /* Check if file is empty or ends with newline */
+  setvbuf(file, NULL, _IOFBF, JOURNAL_WRITE_BUFFER_SIZE);
+
+  bool written = true;
+  for (size_t i = 0; i < count && written; i++) {
+    written = fprintf(file, "%c%s\n", (char)operation, words[i]) > 0;
+  }
+
+  return fclose(file) == 0 && written;
+}
+
+static void apply_journal_record(char operation, const char *word,
+                                 int *word_delta) {
+  char clean[MAX_WORD_LENGTH];
+  if (!remove_slashes_into(word, clean, sizeof(clean))) {
+    return;
+  }
+
+  int index = get_word_letter_index(clean);
+
+  /* Inserting a word that is already present is rejected as a duplicate */
+  if (operation == JOURNAL_INSERT &&
+      insert_word_sorted_by_length(&g_word_lists[index], word) == SUCCESS) {
+    (*word_delta)++;
+  } else if (operation == JOURNAL_DELETE &&
+             delete_word_from_list(&g_word_lists[index], clean)) {
+    (*word_delta)--;
+  }
+}
+
+int replay_journal(const char *filename, int *word_delta, bool *torn) {
+  if (filename == NULL || word_delta == NULL || torn == NULL) {
+    return -1;
+  }
+
+  *word_delta = 0;
+  *torn = false;
+
+  size_t size;
+  const char *data = map_file(filename, &size);
+  if (data == NULL) {
+    return 0; /* No journal yet */
+  }
+
+  int records = 0;
+  size_t pos = 0;
+
+  while (pos < size) {
+    const char *end = memchr(data + pos, '\n', size - pos);
+
+    /* A record without its newline was cut short by a crash */
+    if (end == NULL) {
+      fprintf(stderr, "Warning: Ignoring incomplete journal record\n");
+      *torn = true;
+      break;
+    }
+
+    size_t len = (size_t)(end - (data + pos));
+    const char *record = data + pos;
+    pos += len + 1;
+
+    if (len == 0) {
+      continue;
+    }
+
+    char word[MAX_WORD_LENGTH];
+    if ((record[0] != JOURNAL_INSERT && record[0] != JOURNAL_DELETE) ||
+        len - 1 >= MAX_WORD_LENGTH) {
+      fprintf(stderr, "Warning: Invalid journal record, skipping: %.*s\n",
+              (int)(len < 60 ? len : 60), record);
+      continue;
+    }
+
+    memcpy(word, record + 1, len - 1);
+    word[len - 1] = '\0';
+
+    if (!is_valid_word_format(word)) {
+      fprintf(stderr, "Warning: Invalid journal record, skipping: %.*s\n",
+              (int)len, record);
+      continue;
+    }
+
+    apply_journal_record(record[0], word, word_delta);
+    records++;
+  }
+
+  unmap_file(data, size);
+  return records;
+}
+
+long get_journal_size(void) {
+  FILE *file = fopen(JOURNAL_FILE_PATH, "rb");
+  if (file == NULL) {
+    return 0;
+  }
+
   fseek(file, 0, SEEK_END);
-  long file_size = ftell(file);
+  long size = ftell(file);
+  fclose(file);
+  return size < 0 ? 0 : size;
+}
 
-  if (file_size > 0) {
-    /* Check the last character */
-    fseek(file, -1, SEEK_END);
-    int last_char = fgetc(file);
+/* Batch files */
 
-    /* If file doesn't end with newline, add one before the new word */
-    if (last_char != '\n' && last_char != EOF) {
-      fprintf(file, "\n");
+/* Split a words file into NUL-terminated tokens held in one buffer */
+static char **read_word_tokens(const char *filename, char **buffer,
+                               size_t *count) {
+  size_t size;
+  const char *data = map_file(filename, &size);
+  if (data == NULL) {
+    return NULL;
+  }
+
+  *buffer = (char *)malloc(size + 1);
+  char **tokens = (char **)malloc((size / 2 + 1) * sizeof(char *));
+  if (*buffer == NULL || tokens == NULL) {
+    fprintf(stderr, "Error: Unable to allocate memory for %s\n", filename);
+    free(*buffer);
+    free(tokens);
+    unmap_file(data, size);
+    return NULL;
+  }
+
+  memcpy(*buffer, data, size);
+  (*buffer)[size] = '\0';
+  unmap_file(data, size);
+
+  /* Every token is followed by a delimiter, so there are at most size/2 */
+  *count = 0;
+  char *pos = *buffer;
+  char *end = *buffer + size;
+  while (pos < end) {
+    while (pos < end && is_word_delimiter(*pos)) {
+      pos++;
+    }
+    if (pos == end) {
+      break;
     }
+
+    tokens[(*count)++] = pos;
+    while (pos < end && !is_word_delimiter(*pos)) {
+      pos++;
+    }
+    *pos++ = '\0';
   }
 
-  /* Write the word followed by newline */
-  if (fprintf(file, "%s\n", word) < 0) {
-    fclose(file);
+  return tokens;
+}
+
+int import_words_from_file(const char *filename, BatchResult *result) {
+  if (filename == NULL || result == NULL) {
+    return -1;
+  }
+
+  char *buffer;
+  size_t count;
+  char **tokens = read_word_tokens(filename, &buffer, &count);
+  if (tokens == NULL) {
+    return -1;
+  }
+
+  int applied = insert_word_batch((const char *const *)tokens, count, result);
+  free(tokens);
+  free(buffer);
+  return applied;
+}
+
+int delete_words_from_file(const char *filename, BatchResult *result) {
+  if (filename == NULL || result == NULL) {
+    return -1;
+  }
+
+  char *buffer;
+  size_t count;
+  char **tokens = read_word_tokens(filename, &buffer, &count);
+  if (tokens == NULL) {
+    return -1;
+  }
+
+  int applied = delete_word_batch((const char *const *)tokens, count, result);
+  free(tokens);
+  free(buffer);
+  return applied;
+}
+
+/* Fold the journal into the words file and start an empty journal */
+bool compact_words_file(void) {
+  if (!save_all_words_to_file()) {
     return false;
   }
 
-  fclose(file);
+  /* Once the new words file is in place the journal is redundant */
+  if (remove(JOURNAL_FILE_PATH) != 0) {
+    FILE *file = fopen(JOURNAL_FILE_PATH, "rb");
+    if (file != NULL) {
+      fclose(file);
+      perror("Error removing journal");
+      return false;
+    }
+  }
+
   return true;
 }
 
 bool save_all_words_to_file(void) {
-  FILE *file = fopen(WORDS_FILE_PATH, "w");
+  /* Write a complete copy next to the file, then swap it in */
+  const char *temp_path = WORDS_FILE_PATH ".tmp";
+
+  FILE *file = fopen(temp_path, "w");
   if (file == NULL) {
     perror("Error opening file for writing");
     return false;
   }
 
   /* Write all words from all lists */
-  int words_written = 0;
-  for (int i = 0; i < ALPHABET_SIZE; i++) {
-    WordNode *current = g_word_lists[i].head;
-    while (current != NULL) {
-      if (current->original_word != NULL) {
-        if (fprintf(file, "%s\n", current->original_word) < 0) {
-          fprintf(stderr, "Error writing word to file\n");
-          fclose(file);
-          return false;
-        }
-        words_written++;
+  for (int i = 0; i <= ALPHABET_SIZE; i++) {
+    const LetterList *list = &g_word_lists[i];
+    for (int pos = 0; pos < list->count; pos++) {
+      WordNode *current = word_node_at(list->ids[pos]);
+      if (current->clean_word == NULL) {
+        continue;
+      }
+
+      /* Words are stored without slashes; put them back for the file */
+      char original[MAX_WORD_LENGTH];
+      format_original_word(current, original);
+      if (fprintf(file, "%s\n", original) < 0) {
+        fprintf(stderr, "Error writing word to file\n");
+        fclose(file);
+        remove(temp_path);
+        return false;
       }
-      current = current->next;
     }
   }
 
-  fclose(file);
+  if (fclose(file) != 0) {
+    fprintf(stderr, "Error writing word to file\n");
+    remove(temp_path);
+    return false;
+  }
+
+#ifdef _WIN32
+  /* rename does not replace an existing file on Windows */
+  remove(WORDS_FILE_PATH);
+#endif
+
+  if (rename(temp_path, WORDS_FILE_PATH) != 0) {
+    perror("Error replacing words file");
+    remove(temp_path);
+    return false;
+  }
+
   return true;
-}
\ No newline at end of file
+}
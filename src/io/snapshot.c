@@ -0,0 +1,456 @@
+/**
+ * Dictionary Snapshot
+ * Binary image of the words, their derived fields and every relationship
+ *
+ * The snapshot is written after relationships have been built and is
+ * bound to the exact contents of words.txt and the edit journal by a
+ * 64-bit hash. At startup a
+ * current snapshot replaces parsing, analysis and relationship building:
+ * the file is mapped, the string pool is copied into the arena in one
+ * block and the fixed-size records are turned into nodes in a single
+ * linear pass. Links are stored as 32-bit record indices.
+ *
+ * Layout: SnapshotHeader, record_count SnapshotRecords in list order,
+ * then the string pool. Every string is padded to its arena block size so
+ * each one can later be released on its own like any arena string.
+ */
+
+#include "../../include/english_words.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SNAPSHOT_MAGIC "EWSNAP\r\n"
+#define SNAPSHOT_VERSION 4u
+#define SNAPSHOT_NO_LINK UINT32_MAX
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size;  /* Guards against layout changes */
+  uint64_t source_hash;  /* FNV-1a hash of words.txt, then the journal */
+  uint64_t source_size;  /* Size of words.txt in bytes */
+  uint64_t journal_size; /* Size of the journal in bytes */
+  uint32_t record_count; /* Words stored */
+  uint32_t word_count;   /* Word count reported after loading */
+  uint64_t pool_size;    /* Bytes of string pool after the records */
+} SnapshotHeader;
+
+typedef struct {
+  uint64_t syllable_breaks; /* Bit i set if a syllable starts at letter i */
+  uint32_t clean_offset;    /* Pool offset of the clean word */
+  uint32_t letter_mask;
+  uint32_t links[RELATION_COUNT]; /* Target record index or SNAPSHOT_NO_LINK */
+  uint8_t letter_counts[ALPHABET_SIZE];
+  uint8_t list_index;
+  uint8_t char_count;
+  uint8_t consonant_count;
+  uint8_t vowel_count;
+  uint8_t is_alphabetically_ordered;
+} SnapshotRecord;
+
+/* Source hashing */
+
+/* Continue a 64-bit FNV-1a hash over a file; a missing file is empty */
+static bool hash_file(const char *path, bool required, uint64_t *hash,
+                      uint64_t *size) {
+  size_t length;
+  const char *data = map_file(path, &length);
+  *size = 0;
+  if (data == NULL) {
+    return !required;
+  }
+
+  uint64_t h = *hash;
+  for (size_t i = 0; i < length; i++) {
+    h ^= (unsigned char)data[i];
+    h *= UINT64_C(1099511628211);
+  }
+
+  unmap_file(data, length);
+  *hash = h;
+  *size = (uint64_t)length;
+  return true;
+}
+
+/* Identify the words file and journal a dictionary was built from */
+static bool hash_sources(const char *words_path, const char *journal_path,
+                         SnapshotHeader *sources) {
+  sources->source_hash = UINT64_C(14695981039346656037);
+  return hash_file(words_path, true, &sources->source_hash,
+                   &sources->source_size) &&
+         hash_file(journal_path, false, &sources->source_hash,
+                   &sources->journal_size);
+}
+
+static bool matches_sources(const SnapshotHeader *header,
+                            const char *words_path,
+                            const char *journal_path) {
+  SnapshotHeader sources;
+  return hash_sources(words_path, journal_path, &sources) &&
+         header->source_hash == sources.source_hash &&
+         header->source_size == sources.source_size &&
+         header->journal_size == sources.journal_size;
+}
+
+static bool read_header(const char *data, size_t size, SnapshotHeader *header) {
+  if (size < sizeof(SnapshotHeader)) {
+    return false;
+  }
+
+  memcpy(header, data, sizeof(SnapshotHeader));
+  return memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) == 0 &&
+         header->version == SNAPSHOT_VERSION &&
+         header->record_size == sizeof(SnapshotRecord);
+}
+
+bool is_snapshot_current(const char *snapshot_path, const char *words_path,
+                         const char *journal_path) {
+  if (snapshot_path == NULL || words_path == NULL || journal_path == NULL) {
+    return false;
+  }
+
+  size_t size;
+  const char *data = map_file(snapshot_path, &size);
+  if (data == NULL) {
+    return false;
+  }
+
+  SnapshotHeader header;
+  bool valid = read_header(data, size, &header);
+  unmap_file(data, size);
+
+  return valid && matches_sources(&header, words_path, journal_path);
+}
+
+/* Loading */
+
+static bool is_pool_string(uint32_t offset, const SnapshotHeader *header,
+                           const char *pool) {
+  return offset < header->pool_size &&
+         offset % arena_block_size(1) == 0 &&
+         memchr(pool + offset, '\0', header->pool_size - offset) != NULL;
+}
+
+/*
+ * Check every offset and index before anything is built from the file.
+ * The source hash does not cover the snapshot itself, so a damaged record
+ * must fail here (or as a repeated word when it is appended) and leave
+ * the caller to rebuild.
+ */
+static bool validate_records(const SnapshotHeader *header,
+                             const SnapshotRecord *records, const char *pool) {
+  /* Strings are written in record order, one arena block each */
+  uint64_t next_offset = 0;
+
+  for (uint32_t i = 0; i < header->record_count; i++) {
+    const SnapshotRecord *record = &records[i];
+
+    if (record->clean_offset != next_offset ||
+        !is_pool_string(record->clean_offset, header, pool) ||
+        record->list_index >= ALPHABET_SIZE) {
+      return false;
+    }
+
+    const char *word = pool + record->clean_offset;
+    size_t length = strlen(word);
+    if (length == 0 || length >= MAX_WORD_LENGTH ||
+        length != record->char_count) {
+      return false;
+    }
+    next_offset += arena_block_size(length + 1);
+
+    /* ASCII letters only, stored in the list of the first one */
+    CharClasses classes;
+    classify_characters(word, length, &classes);
+    int vowels = count_bits(classes.vowels);
+    if (count_bits(classes.letters) != (int)length ||
+        ((word[0] | 0x20) - 'a') != record->list_index ||
+        vowels != record->vowel_count ||
+        (int)length - vowels != record->consonant_count) {
+      return false;
+    }
+
+    /* sort_letters places letters by these counts */
+    unsigned char counts[ALPHABET_SIZE] = {0};
+    uint32_t mask = 0;
+    for (size_t k = 0; k < length; k++) {
+      int letter = (word[k] | 0x20) - 'a';
+      counts[letter]++;
+      mask |= 1u << letter;
+    }
+    if (memcmp(counts, record->letter_counts, ALPHABET_SIZE) != 0 ||
+        mask != record->letter_mask) {
+      return false;
+    }
+
+    /* Breaks fall between letters, and the slashed form must fit */
+    uint64_t inner = ((uint64_t)1 << length) - 2;
+    if ((record->syllable_breaks & ~inner) != 0 ||
+        length + (size_t)count_bits(record->syllable_breaks) >=
+            MAX_WORD_LENGTH) {
+      return false;
+    }
+
+    for (int kind = 0; kind < RELATION_COUNT; kind++) {
+      if (record->links[kind] != SNAPSHOT_NO_LINK &&
+          record->links[kind] >= header->record_count) {
+        return false;
+      }
+    }
+  }
+  return next_offset == header->pool_size;
+}
+
+static WordNode *restore_node(const SnapshotRecord *record, char *pool) {
+  WordNode *node = allocate_word_node();
+  if (node == NULL) {
+    return NULL;
+  }
+
+  node->clean_word = pool + record->clean_offset;
+  node->syllable_breaks = record->syllable_breaks;
+  node->char_count = record->char_count;
+  node->consonant_count = record->consonant_count;
+  node->vowel_count = record->vowel_count;
+  node->is_alphabetically_ordered = record->is_alphabetically_ordered != 0;
+  node->letter_mask = record->letter_mask;
+  memcpy(node->letter_counts, record->letter_counts, ALPHABET_SIZE);
+  pack_word(node->clean_word, &node->packed);
+  return node;
+}
+
+static bool restore_dictionary(const SnapshotHeader *header,
+                               const SnapshotRecord *records,
+                               const char *mapped_pool) {
+  char *pool = NULL;
+  if (header->pool_size > 0) {
+    pool = (char *)arena_alloc((size_t)header->pool_size);
+    if (pool == NULL) {
+      return false;
+    }
+    memcpy(pool, mapped_pool, (size_t)header->pool_size);
+  }
+
+  WordNode **nodes = NULL;
+  if (header->record_count > 0) {
+    nodes = (WordNode **)malloc(header->record_count * sizeof(WordNode *));
+    if (nodes == NULL) {
+      return false;
+    }
+  }
+
+  /* Records are stored in list order, so each one goes to a list's end */
+  for (uint32_t i = 0; i < header->record_count; i++) {
+    int list = records[i].list_index;
+    nodes[i] = restore_node(&records[i], pool);
+
+    if (nodes[i] == NULL ||
+        append_word_node(&g_word_lists[list], nodes[i]) != SUCCESS) {
+      free(nodes);
+      return false;
+    }
+  }
+
+  /* Setting the links also rebuilds backlinks and link counts */
+  for (uint32_t i = 0; i < header->record_count; i++) {
+    WordNode *targets[RELATION_COUNT];
+    for (int kind = 0; kind < RELATION_COUNT; kind++) {
+      uint32_t target = records[i].links[kind];
+      targets[kind] = target != SNAPSHOT_NO_LINK ? nodes[target] : NULL;
+    }
+    restore_relationship_links(nodes[i], targets);
+  }
+
+  free(nodes);
+  return true;
+}
+
+bool load_snapshot(const char *snapshot_path, const char *words_path,
+                   const char *journal_path, int *word_count) {
+  if (snapshot_path == NULL || words_path == NULL || journal_path == NULL ||
+      word_count == NULL) {
+    return false;
+  }
+
+  size_t size;
+  const char *data = map_file(snapshot_path, &size);
+  if (data == NULL) {
+    return false;
+  }
+
+  SnapshotHeader header;
+  bool usable = read_header(data, size, &header) &&
+                matches_sources(&header, words_path, journal_path) &&
+                (uint64_t)size == sizeof(SnapshotHeader) +
+                                      (uint64_t)header.record_count *
+                                          sizeof(SnapshotRecord) +
+                                      header.pool_size;
+
+  const SnapshotRecord *records =
+      (const SnapshotRecord *)(data + sizeof(SnapshotHeader));
+  const char *pool =
+      (const char *)(records + (usable ? header.record_count : 0));
+
+  if (!usable || !validate_records(&header, records, pool)) {
+    unmap_file(data, size);
+    return false;
+  }
+
+  reset_word_lists();
+
+  bool restored = restore_dictionary(&header, records, pool);
+  unmap_file(data, size);
+
+  if (!restored) {
+    fprintf(stderr, "Error: Unable to restore snapshot, rebuilding.\n");
+    cleanup_word_lists();
+    return false;
+  }
+
+  *word_count = (int)header.word_count;
+  return true;
+}
+
+/* Saving */
+
+static int compare_nodes(const void *a, const void *b) {
+  return compare_word_order(*(WordNode *const *)a, *(WordNode *const *)b);
+}
+
+/* Nodes are sorted in list order, so a target's index is found by search */
+static uint32_t find_record_index(WordNode **nodes, size_t count,
+                                  WordNode *target) {
+  if (target == NULL) {
+    return SNAPSHOT_NO_LINK;
+  }
+
+  WordNode **found = (WordNode **)bsearch(&target, nodes, count,
+                                          sizeof(WordNode *), compare_nodes);
+  return found != NULL ? (uint32_t)(found - nodes) : SNAPSHOT_NO_LINK;
+}
+
+static bool write_pool_string(FILE *file, const char *text) {
+  static const char padding[16] = {0};
+  size_t length = strlen(text) + 1;
+  size_t block = arena_block_size(length);
+
+  return fwrite(text, 1, length, file) == length &&
+         fwrite(padding, 1, block - length, file) == block - length;
+}
+
+static bool write_snapshot(FILE *file, WordNode **nodes, size_t count,
+                           SnapshotHeader *header) {
+  if (fwrite(header, sizeof(SnapshotHeader), 1, file) != 1) {
+    return false;
+  }
+
+  uint64_t pool_size = 0;
+  for (size_t i = 0; i < count; i++) {
+    const WordNode *node = nodes[i];
+    SnapshotRecord record;
+    memset(&record, 0, sizeof(record));
+
+    record.syllable_breaks = node->syllable_breaks;
+    record.clean_offset = (uint32_t)pool_size;
+    pool_size += arena_block_size(strlen(node->clean_word) + 1);
+
+    record.letter_mask = node->letter_mask;
+    for (int kind = 0; kind < RELATION_COUNT; kind++) {
+      record.links[kind] = find_record_index(
+          nodes, count, linked_word(node, (RelationKind)kind));
+    }
+    memcpy(record.letter_counts, node->letter_counts, ALPHABET_SIZE);
+    record.list_index = (uint8_t)get_word_letter_index(node->clean_word);
+    record.char_count = (uint8_t)node->char_count;
+    record.consonant_count = (uint8_t)node->consonant_count;
+    record.vowel_count = (uint8_t)node->vowel_count;
+    record.is_alphabetically_ordered = node->is_alphabetically_ordered;
+
+    if (fwrite(&record, sizeof(record), 1, file) != 1) {
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    if (!write_pool_string(file, nodes[i]->clean_word)) {
+      return false;
+    }
+  }
+
+  /* Fill in the pool size now that it is known */
+  header->pool_size = pool_size;
+  return fseek(file, 0, SEEK_SET) == 0 &&
+         fwrite(header, sizeof(SnapshotHeader), 1, file) == 1;
+}
+
+bool save_snapshot(const char *snapshot_path, const char *words_path,
+                   const char *journal_path, int word_count) {
+  if (snapshot_path == NULL || words_path == NULL || journal_path == NULL) {
+    return false;
+  }
+
+  SnapshotHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+  header.version = SNAPSHOT_VERSION;
+  header.record_size = sizeof(SnapshotRecord);
+  header.word_count = word_count > 0 ? (uint32_t)word_count : 0;
+  if (!hash_sources(words_path, journal_path, &header)) {
+    return false;
+  }
+
+  /* Collect the words in list order */
+  size_t count = 0;
+  for (int i = 0; i < ALPHABET_SIZE; i++) {
+    count += (size_t)g_word_lists[i].count;
+  }
+
+  WordNode **nodes = (WordNode **)malloc((count + 1) * sizeof(WordNode *));
+  if (nodes == NULL) {
+    fprintf(stderr, "Error: Unable to allocate memory for snapshot.\n");
+    return false;
+  }
+
+  count = 0;
+  for (int i = 0; i < ALPHABET_SIZE; i++) {
+    const LetterList *list = &g_word_lists[i];
+    for (int pos = 0; pos < list->count; pos++) {
+      WordNode *current = word_node_at(list->ids[pos]);
+      if (current->clean_word != NULL) {
+        nodes[count++] = current;
+      }
+    }
+  }
+  header.record_count = (uint32_t)count;
+
+  /* Write next to the target and rename, so a crash never leaves half */
+  char temp_path[FILENAME_MAX];
+  snprintf(temp_path, sizeof(temp_path), "%s.tmp", snapshot_path);
+
+  FILE *file = fopen(temp_path, "wb");
+  if (file == NULL) {
+    free(nodes);
+    return false;
+  }
+
+  bool written = write_snapshot(file, nodes, count, &header);
+  written = fclose(file) == 0 && written;
+  free(nodes);
+
+#ifdef _WIN32
+  /* rename does not replace an existing file on Windows */
+  if (written) {
+    remove(snapshot_path);
+  }
+#endif
+
+  if (!written || rename(temp_path, snapshot_path) != 0) {
+    fprintf(stderr, "Warning: Unable to write snapshot %s\n", snapshot_path);
+    remove(temp_path);
+    return false;
+  }
+
+  return true;
+}
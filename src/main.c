@@ -7,42 +7,96 @@
 #include "../include/ui.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define WORDS_FILE "persistence/words.txt"
+#define JOURNAL_FILE "persistence/words.journal"
+#define SNAPSHOT_FILE "persistence/words.snapshot"
 
-int main(void) {
-  ui_clear_screen();
-  puts("English Words Analysis Program");
-  puts("==============================\n");
+/* Command-line option leaving relationships to be computed on first use */
+#define LAZY_OPTION "--lazy"
+
+/* Journal size past which it is folded into the words file at exit */
+#define JOURNAL_COMPACT_THRESHOLD (64 * 1024)
+
+/* Parse the words file and build every relationship, now or lazily */
+static bool build_dictionary(Statistics *stats, bool lazy) {
   printf("Loading words from %s...\n", WORDS_FILE);
 
-  /* Load words from file */
-  int word_count = load_words_from_file(WORDS_FILE);
+  /* Load words from file; repeated words are dropped as they arrive */
+  int duplicates;
+  int word_count = load_words_from_file(WORDS_FILE, &duplicates);
   if (word_count == -1) {
     printf("Error: Unable to open file '%s'.\n", WORDS_FILE);
     printf("Make sure the file exists in the persistence directory.\n");
-    return EXIT_FAILURE;
+    return false;
+  }
+
+  printf("Loaded %d unique words (%d duplicates dropped).\n", word_count,
+         duplicates);
+
+  /* Apply the edits made since the words file was last written */
+  int word_delta;
+  bool torn;
+  int records = replay_journal(JOURNAL_FILE, &word_delta, &torn);
+  if (records > 0) {
+    printf("Replayed %d journal records.\n", records);
+    word_count += word_delta;
   }
 
-  printf("Loaded %d words.\n", word_count);
+  /* Drop a record cut short by a crash before anything is appended */
+  if (torn) {
+    compact_words_file();
+  }
 
-  /* Remove duplicate words */
-  remove_duplicate_words();
+  stats->word_count = word_count;
+
+  /* Each relation is searched by the first view or lookup needing it */
+  if (lazy) {
+    printf("Relationships will be computed on first use.\n");
+    defer_relationships();
+    return true;
+  }
 
   printf("Building relationships...\n");
 
-  /* Create word relationships */
-  int subword_links = create_subword_links();
-  int verb_form_links = create_verb_form_links();
-  int lexclose_links = create_lexically_close_links();
-  int anagram_links = create_anagram_links();
+  /* Create word relationships, every relation at once on all cores */
+  rebuild_relationships();
 
   /* Store statistics */
-  Statistics stats = {.word_count = word_count,
-                      .subword_links = subword_links,
-                      .verb_form_links = verb_form_links,
-                      .lexclose_links = lexclose_links,
-                      .anagram_links = anagram_links};
+  update_link_statistics(stats);
+
+  /* Save the result so the next start can skip all of the above */
+  save_snapshot(SNAPSHOT_FILE, WORDS_FILE, JOURNAL_FILE, word_count);
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  bool lazy = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], LAZY_OPTION) == 0) {
+      lazy = true;
+    } else {
+      fprintf(stderr, "Usage: %s [%s]\n", argv[0], LAZY_OPTION);
+      return EXIT_FAILURE;
+    }
+  }
+
+  ui_clear_screen();
+  puts("English Words Analysis Program");
+  puts("==============================\n");
+
+  Statistics stats = {0};
+
+  /* A snapshot matching the words file and journal replaces building */
+  int word_count;
+  if (load_snapshot(SNAPSHOT_FILE, WORDS_FILE, JOURNAL_FILE, &word_count)) {
+    printf("Loaded %d words from %s.\n", word_count, SNAPSHOT_FILE);
+    stats.word_count = word_count;
+    update_link_statistics(&stats);
+  } else if (!build_dictionary(&stats, lazy)) {
+    return EXIT_FAILURE;
+  }
 
   /* Display initial word lists */
   print_all_word_lists();
@@ -51,8 +105,23 @@ int main(void) {
   ui_wait_for_enter();
   ui_main_menu_loop(&stats);
 
+  /* Fold a long journal back into the words file */
+  if (get_journal_size() > JOURNAL_COMPACT_THRESHOLD) {
+    compact_words_file();
+  }
+
+  /*
+   * Refresh the snapshot if edits changed the words file or journal; a
+   * lazy session with links still deferred leaves it to the next start
+   */
+  if (!relationships_deferred() &&
+      !is_snapshot_current(SNAPSHOT_FILE, WORDS_FILE, JOURNAL_FILE)) {
+    save_snapshot(SNAPSHOT_FILE, WORDS_FILE, JOURNAL_FILE, stats.word_count);
+  }
+
   /* Cleanup */
   cleanup_word_lists();
+  stop_thread_pool();
 
   ui_clear_screen();
   puts("Program terminated.");
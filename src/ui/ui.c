@@ -13,6 +13,11 @@
 #include <stdlib.h>
 #include <string.h>
 
+#define MAX_LEXICAL_NEIGHBOURS 32
+#define MAX_QUERY_CONDITIONS 8
+#define MAX_QUERY_RESULTS 200
+#define HISTOGRAM_BAR_WIDTH 40
+
 #ifdef _WIN32
 #define CLEAR_COMMAND "cls"
 #else
@@ -44,6 +49,12 @@ void ui_display_menu(void) {
   puts("7) Delete a word");
   puts("8) Display statistics");
   puts("9) Exit");
+  puts("10) Compact the word file");
+  puts("11) Import words from a file");
+  puts("12) Delete the words listed in a file");
+  puts("13) Query words by counts");
+  puts("14) Display count histograms");
+  puts("15) Display inflections (-s/-er/-est)");
   printf("\nYour choice: ");
   fflush(stdout);
 }
@@ -81,6 +92,46 @@ static char *read_word_input(const char *prompt) {
   return word;
 }
 
+static char *read_line_input(const char *prompt) {
+  static char path[FILENAME_MAX];
+
+  printf("%s", prompt);
+  fflush(stdout);
+
+  if (fgets(path, sizeof(path), stdin) == NULL) {
+    return NULL;
+  }
+
+  /* Remove trailing whitespace */
+  size_t len = strlen(path);
+  while (len > 0 && isspace((unsigned char)path[len - 1])) {
+    path[--len] = '\0';
+  }
+
+  return len > 0 ? path : NULL;
+}
+
+static void print_lexical_neighbours(const char *word) {
+  WordNode *neighbours[MAX_LEXICAL_NEIGHBOURS];
+  int count =
+      find_lexically_close_words(word, neighbours, MAX_LEXICAL_NEIGHBOURS);
+
+  printf("\nWords one letter away:     ");
+  if (count == 0) {
+    puts("none");
+    return;
+  }
+
+  int shown = count < MAX_LEXICAL_NEIGHBOURS ? count : MAX_LEXICAL_NEIGHBOURS;
+  for (int i = 0; i < shown; i++) {
+    printf("%s%s", i > 0 ? ", " : "", neighbours[i]->clean_word);
+  }
+  if (count > shown) {
+    printf(" (+%d more)", count - shown);
+  }
+  printf("\n");
+}
+
 static void handle_print_word_data(Statistics *stats) {
   (void)stats;
 
@@ -95,27 +146,30 @@ static void handle_print_word_data(Statistics *stats) {
   ui_clear_screen();
 
   /* Remove slashes for searching */
-  char *clean = remove_slashes(word);
-  if (clean == NULL) {
-    puts("Error allocating memory.");
-    return;
-  }
-
-  int index = get_word_letter_index(clean);
-  if (index < 0 || index > ALPHABET_SIZE) {
+  char clean[MAX_WORD_LENGTH];
+  if (!remove_slashes_into(word, clean, sizeof(clean))) {
     puts("Invalid word.");
-    free(clean);
     return;
   }
 
-  WordNode *node = search_word(g_word_lists[index].head, clean);
-  free(clean);
+  WordNode *node = search_word(clean);
 
   if (node == NULL) {
     puts("This word does not exist in the dictionary.");
   } else {
+    ensure_word_links(node);
+    ensure_anagram_classes();
     print_word_details(node);
   }
+
+  /* Answered from the pattern index, so it also works for unknown words */
+  print_lexical_neighbours(clean);
+}
+
+/* In lazy mode, a list view first links every word by its relation */
+static void ensure_listed_relation(Statistics *stats, RelationKind kind) {
+  ensure_relation_links(kind);
+  update_link_statistics(stats);
 }
 
 static void handle_print_subwords(int link_count) {
@@ -140,9 +194,26 @@ static void handle_print_verb_forms(int link_count) {
   }
 }
 
-static void handle_print_add_one_char(void) {
+static void handle_print_inflections(int link_count) {
   ui_clear_screen();
-  puts("Feature not yet implemented.");
+
+  if (link_count >= 1) {
+    puts("=== Inflections (-s/-er/-est) ===\n");
+    print_inflections();
+  } else {
+    puts("No inflections found.");
+  }
+}
+
+static void handle_print_add_one_char(int link_count) {
+  ui_clear_screen();
+
+  if (link_count >= 1) {
+    puts("=== Words Formed by Adding One Character ===\n");
+    print_add_one_char_chains();
+  } else {
+    puts("No words formed by adding one character found.");
+  }
 }
 
 static void handle_print_lexically_close(int link_count) {
@@ -161,6 +232,7 @@ static void handle_print_anagrams(int link_count) {
 
   if (link_count >= 1) {
     puts("=== Anagrams ===\n");
+    ensure_anagram_classes();
     print_anagrams();
   } else {
     puts("No anagrams found.");
@@ -193,38 +265,28 @@ static void handle_insert_word(Statistics *stats) {
   }
 
   /* Check with clean word */
-  char *clean = remove_slashes(word);
-  if (clean == NULL) {
-    puts("Error allocating memory.");
+  char clean[MAX_WORD_LENGTH];
+  if (!remove_slashes_into(word, clean, sizeof(clean))) {
+    puts("Invalid word.");
     return;
   }
 
-  WordNode *existing = search_word(g_word_lists[index].head, clean);
-  free(clean);
+  /* The word index rejects a word that is already present */
+  ErrorCode result = insert_word_sorted_by_length(&g_word_lists[index], word);
 
-  if (existing != NULL) {
+  if (result == ERROR_WORD_EXISTS) {
     puts("This word already exists.");
+  } else if (result != SUCCESS) {
+    printf("Failed to insert word (error code: %d).\n", result);
   } else {
-    ErrorCode result =
-        insert_word_sorted_by_length(&g_word_lists[index].head, word);
-
-    if (result != SUCCESS) {
-      printf("Failed to insert word (error code: %d).\n", result);
-      return;
-    }
-
-    /* Save to file */
-    if (save_word_to_file(word)) {
-      puts("Word successfully added and saved to words.txt");
-
-      /* Recalculate relationships */
-      printf("Recalculating relationships...\n");
-      stats->subword_links = create_subword_links();
-      stats->verb_form_links = create_verb_form_links();
-      stats->lexclose_links = create_lexically_close_links();
-      stats->anagram_links = create_anagram_links();
-      stats->word_count++;
-      printf("Done!\n");
+    /* Update only the links affected by the new word */
+    add_word_relationships(search_word(clean));
+    update_link_statistics(stats);
+    stats->word_count++;
+
+    /* Record the edit in the journal */
+    if (append_journal_record(JOURNAL_INSERT, word)) {
+      puts("Word successfully added and saved to words.journal");
     } else {
       puts("Word added but failed to save to file.");
     }
@@ -243,35 +305,34 @@ static void handle_delete_word(Statistics *stats) {
   ui_clear_screen();
 
   /* Remove slashes for searching */
-  char *clean = remove_slashes(word);
-  if (clean == NULL) {
-    puts("Error allocating memory.");
+  char clean[MAX_WORD_LENGTH];
+  if (!remove_slashes_into(word, clean, sizeof(clean))) {
+    puts("Invalid word.");
     return;
   }
 
   int index = get_word_letter_index(clean);
   if (index < 0 || index > ALPHABET_SIZE) {
     puts("Invalid word.");
-    free(clean);
     return;
   }
 
-  bool deleted = delete_word_from_list(&g_word_lists[index].head, clean);
-  free(clean);
+  /* Relink the words pointing at it before the node is freed */
+  WordNode *node = search_word(clean);
+  if (node != NULL) {
+    remove_word_relationships(node);
+  }
+
+  bool deleted = node != NULL &&
+                 delete_word_from_list(&g_word_lists[index], clean);
 
   if (deleted) {
-    /* Save all words back to file */
-    if (save_all_words_to_file()) {
-      puts("Word successfully deleted and changes saved to words.txt");
-
-      /* Recalculate relationships */
-      printf("Recalculating relationships...\n");
-      stats->subword_links = create_subword_links();
-      stats->verb_form_links = create_verb_form_links();
-      stats->lexclose_links = create_lexically_close_links();
-      stats->anagram_links = create_anagram_links();
-      stats->word_count--;
-      printf("Done!\n");
+    update_link_statistics(stats);
+    stats->word_count--;
+
+    /* Record the edit in the journal */
+    if (append_journal_record(JOURNAL_DELETE, clean)) {
+      puts("Word successfully deleted and changes saved to words.journal");
     } else {
       puts("Word deleted but failed to save changes to file.");
     }
@@ -280,6 +341,138 @@ static void handle_delete_word(Statistics *stats) {
   }
 }
 
+static void print_batch_result(const BatchResult *result) {
+  printf("Duplicates skipped:            %d\n", result->duplicates);
+  printf("Invalid words skipped:         %d\n", result->invalid);
+  if (!result->saved) {
+    puts("Warning: failed to save the changes to words.journal");
+  }
+}
+
+static void handle_import_words(Statistics *stats) {
+  char *path = read_line_input("Enter the file to import: ");
+  ui_clear_screen();
+
+  BatchResult result;
+  if (path == NULL || import_words_from_file(path, &result) < 0) {
+    puts("Unable to read the import file.");
+    return;
+  }
+
+  update_link_statistics(stats);
+  stats->word_count += result.applied;
+
+  printf("Words imported:                %d\n", result.applied);
+  print_batch_result(&result);
+}
+
+static void handle_delete_words(Statistics *stats) {
+  char *path = read_line_input("Enter the file listing words to delete: ");
+  ui_clear_screen();
+
+  BatchResult result;
+  if (path == NULL || delete_words_from_file(path, &result) < 0) {
+    puts("Unable to read the file.");
+    return;
+  }
+
+  update_link_statistics(stats);
+  stats->word_count -= result.applied;
+
+  printf("Words deleted:                 %d\n", result.applied);
+  printf("Unknown words skipped:         %d\n", result.missing);
+  print_batch_result(&result);
+}
+
+static void handle_compact_words_file(void) {
+  ui_clear_screen();
+
+  if (compact_words_file()) {
+    puts("Journal folded into words.txt.");
+  } else {
+    puts("Failed to compact the word file.");
+  }
+}
+
+static void handle_query_words(void) {
+  char *text =
+      read_line_input("Enter a query (e.g. syllables=3 vowels>4 length<=8): ");
+  ui_clear_screen();
+
+  QueryCondition conditions[MAX_QUERY_CONDITIONS];
+  int condition_count =
+      text != NULL
+          ? parse_word_query(text, conditions, MAX_QUERY_CONDITIONS)
+          : -1;
+  if (condition_count < 0) {
+    puts("Invalid query. Combine terms such as syllables=3 vowels>4,");
+    puts("using length, consonants, vowels, syllables or ordered with");
+    puts("=, !=, <, <=, > or >=.");
+    return;
+  }
+
+  WordNode *results[MAX_QUERY_RESULTS];
+  int matches =
+      run_word_query(conditions, condition_count, results, MAX_QUERY_RESULTS);
+  if (matches < 0) {
+    puts("Unable to run the query.");
+    return;
+  }
+
+  printf("=== Query: %s ===\n", text);
+  int shown = matches < MAX_QUERY_RESULTS ? matches : MAX_QUERY_RESULTS;
+  for (int i = 0; i < shown; i++) {
+    printf("%s%s", i > 0 ? ", " : "", results[i]->clean_word);
+  }
+  if (shown > 0) {
+    printf("\n");
+  }
+  if (matches > shown) {
+    printf("... and %d more\n", matches - shown);
+  }
+  printf("\nMatching words: %d\n", matches);
+}
+
+static void print_histogram(WordColumn column) {
+  int bins[HISTOGRAM_BINS];
+  compute_word_histogram(column, bins);
+
+  int largest = 0;
+  for (int i = 0; i < HISTOGRAM_BINS; i++) {
+    if (bins[i] > largest) {
+      largest = bins[i];
+    }
+  }
+
+  printf("\n=== Words by %s ===\n", word_column_name(column));
+  if (largest == 0) {
+    puts("(empty)");
+    return;
+  }
+
+  for (int i = 0; i < HISTOGRAM_BINS; i++) {
+    if (bins[i] == 0) {
+      continue;
+    }
+
+    /* Every non-empty bin gets at least one mark */
+    int width = (int)((long)bins[i] * HISTOGRAM_BAR_WIDTH / largest);
+    printf("%3d: %7d ", i, bins[i]);
+    for (int w = 0; w < (width > 0 ? width : 1); w++) {
+      putchar('#');
+    }
+    putchar('\n');
+  }
+}
+
+static void handle_print_histograms(void) {
+  ui_clear_screen();
+
+  print_histogram(COLUMN_CHARACTERS);
+  print_histogram(COLUMN_VOWELS);
+  print_histogram(COLUMN_SYLLABLES);
+}
+
 static void handle_print_stats(const Statistics *stats) {
   if (stats == NULL) {
     puts("Error: Statistics not available.");
@@ -289,11 +482,24 @@ static void handle_print_stats(const Statistics *stats) {
   ui_clear_screen();
 
   puts("=== Statistics ===");
-  printf("Total words read:              %d\n", stats->word_count);
+  printf("Unique words:                  %d\n", stats->word_count);
   printf("Subword links created:         %d\n", stats->subword_links);
   printf("Verb form links created:       %d\n", stats->verb_form_links);
+  printf("Inflection links created:      %d\n", stats->inflection_links);
+  printf("Add-one-char links created:    %d\n", stats->add_one_char_links);
   printf("Lexically close links created: %d\n", stats->lexclose_links);
   printf("Anagram links created:         %d\n", stats->anagram_links);
+
+  ArenaStatistics arena;
+  get_arena_statistics(&arena);
+  size_t handed_out = arena.bytes_used + arena.bytes_free;
+
+  puts("\n=== Memory ===");
+  printf("Arena bytes reserved:          %zu\n", arena.bytes_reserved);
+  printf("Arena bytes used:              %zu\n", arena.bytes_used);
+  printf("Arena fragmentation:           %.1f%%\n",
+         handed_out > 0 ? 100.0 * (double)arena.bytes_free / (double)handed_out
+                        : 0.0);
 }
 
 void ui_main_menu_loop(Statistics *stats) {
@@ -332,6 +538,7 @@ void ui_main_menu_loop(Statistics *stats) {
       break;
 
     case MENU_PRINT_SUBWORDS:
+      ensure_listed_relation(stats, RELATION_SUBWORD);
       handle_print_subwords(stats->subword_links);
       ui_wait_for_enter();
       ui_clear_screen();
@@ -339,6 +546,7 @@ void ui_main_menu_loop(Statistics *stats) {
       break;
 
     case MENU_PRINT_VERB_FORMS:
+      ensure_listed_relation(stats, RELATION_ED_FORM);
       handle_print_verb_forms(stats->verb_form_links);
       ui_wait_for_enter();
       ui_clear_screen();
@@ -346,13 +554,15 @@ void ui_main_menu_loop(Statistics *stats) {
       break;
 
     case MENU_PRINT_ADD_ONE_CHAR:
-      handle_print_add_one_char();
+      ensure_listed_relation(stats, RELATION_ADD_ONE_CHAR);
+      handle_print_add_one_char(stats->add_one_char_links);
       ui_wait_for_enter();
       ui_clear_screen();
       print_all_word_lists();
       break;
 
     case MENU_PRINT_LEXICALLY_CLOSE:
+      ensure_listed_relation(stats, RELATION_LEXICALLY_CLOSE);
       handle_print_lexically_close(stats->lexclose_links);
       ui_wait_for_enter();
       ui_clear_screen();
@@ -360,6 +570,7 @@ void ui_main_menu_loop(Statistics *stats) {
       break;
 
     case MENU_PRINT_ANAGRAMS:
+      ensure_listed_relation(stats, RELATION_ANAGRAM);
       handle_print_anagrams(stats->anagram_links);
       ui_wait_for_enter();
       ui_clear_screen();
@@ -381,12 +592,57 @@ void ui_main_menu_loop(Statistics *stats) {
       break;
 
     case MENU_PRINT_STATS:
+      ensure_relationship_links();
+      update_link_statistics(stats);
       handle_print_stats(stats);
       ui_wait_for_enter();
       ui_clear_screen();
       print_all_word_lists();
       break;
 
+    case MENU_COMPACT_WORDS_FILE:
+      handle_compact_words_file();
+      ui_wait_for_enter();
+      ui_clear_screen();
+      print_all_word_lists();
+      break;
+
+    case MENU_IMPORT_WORDS:
+      handle_import_words(stats);
+      ui_wait_for_enter();
+      ui_clear_screen();
+      print_all_word_lists();
+      break;
+
+    case MENU_DELETE_WORDS:
+      handle_delete_words(stats);
+      ui_wait_for_enter();
+      ui_clear_screen();
+      print_all_word_lists();
+      break;
+
+    case MENU_QUERY_WORDS:
+      handle_query_words();
+      ui_wait_for_enter();
+      ui_clear_screen();
+      print_all_word_lists();
+      break;
+
+    case MENU_PRINT_HISTOGRAMS:
+      handle_print_histograms();
+      ui_wait_for_enter();
+      ui_clear_screen();
+      print_all_word_lists();
+      break;
+
+    case MENU_PRINT_INFLECTIONS:
+      ensure_listed_relation(stats, RELATION_S_FORM);
+      handle_print_inflections(stats->inflection_links);
+      ui_wait_for_enter();
+      ui_clear_screen();
+      print_all_word_lists();
+      break;
+
     case MENU_EXIT:
       return;
 
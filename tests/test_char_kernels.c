@@ -0,0 +1,115 @@
+/**
+ * Character Kernel Test
+ * Compare every character kernel with isalpha and is_vowel
+ *
+ * Usage: test_char_kernels [rounds]
+ *
+ * Random text is classified with every kernel the CPU supports, and each
+ * letter, vowel and slash mask must match the one built character by
+ * character from isalpha, is_vowel and '/'. The kernels are static, so
+ * char_class.c is compiled into this program rather than linked from the
+ * library. It is run from several seeds; the program exits non-zero on the
+ * first mismatch.
+ */
+
+#include "../src/core/char_class.c"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DEFAULT_ROUNDS 100000
+
+static const unsigned int g_seeds[] = {1u, 12345u, 0xC0FFEEu, 0xDEADBEEFu,
+                                       0xFFFFFFFFu};
+
+#define SEED_COUNT (sizeof(g_seeds) / sizeof(g_seeds[0]))
+
+static const char g_alphabet[] = "aeiouyAEIOUYbcdxzBCDXZ/`{@[ \x80\xff";
+
+#define ALPHABET_LENGTH (sizeof(g_alphabet) - 1)
+
+static unsigned int next_random(unsigned int *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+/* The masks one character at a time, from the C library */
+static void classify_reference(const char *text, size_t length,
+                               CharClasses *classes) {
+  classes->letters = 0;
+  classes->vowels = 0;
+  classes->slashes = 0;
+
+  for (size_t i = 0; i < length; i++) {
+    uint64_t bit = (uint64_t)1 << i;
+    if (isalpha((unsigned char)text[i])) {
+      classes->letters |= bit;
+      if (is_vowel(text[i])) {
+        classes->vowels |= bit;
+      }
+    } else if (text[i] == '/') {
+      classes->slashes |= bit;
+    }
+  }
+}
+
+static bool check_kernels(unsigned int seed, int rounds) {
+  /* A zero state would stay zero */
+  unsigned int state = seed != 0 ? seed : 1u;
+
+  for (int round = 0; round < rounds; round++) {
+    char text[CHAR_CLASS_WINDOW];
+    size_t length = next_random(&state) % (CHAR_CLASS_WINDOW + 1);
+
+    /* Mostly word characters, with every byte value showing up */
+    for (size_t i = 0; i < length; i++) {
+      text[i] = next_random(&state) % 4 == 0
+                    ? (char)(next_random(&state) % 256)
+                    : g_alphabet[next_random(&state) % ALPHABET_LENGTH];
+    }
+
+    CharClasses expected;
+    classify_reference(text, length, &expected);
+
+    for (int kernel = CHAR_KERNEL_SCALAR; kernel < CHAR_KERNEL_COUNT;
+         kernel++) {
+      if (!kernel_available((CharKernel)kernel)) {
+        continue;
+      }
+
+      CharClasses actual;
+      classify_with((CharKernel)kernel, text, length, &actual);
+      if (actual.letters != expected.letters ||
+          actual.vowels != expected.vowels ||
+          actual.slashes != expected.slashes) {
+        fprintf(stderr,
+                "Error: Character kernel %d differs from the reference for "
+                "%zu characters.\n",
+                kernel, length);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  int rounds = argc > 1 ? atoi(argv[1]) : DEFAULT_ROUNDS;
+  if (rounds <= 0) {
+    fprintf(stderr, "Usage: %s [rounds]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  for (size_t i = 0; i < SEED_COUNT; i++) {
+    if (!check_kernels(g_seeds[i], rounds)) {
+      fprintf(stderr, "test_char_kernels: failed with seed %u\n", g_seeds[i]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  printf("test_char_kernels: %d rounds from %d seeds passed\n", rounds,
+         (int)SEED_COUNT);
+  return EXIT_SUCCESS;
+}
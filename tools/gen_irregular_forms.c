@@ -0,0 +1,422 @@
+/**
+ * Irregular Form Table Generator
+ * Compile the irregular form data file into a perfect hash table header
+ *
+ * Usage: gen_irregular_forms <data file> <header>
+ *
+ * Words are hashed into buckets of about four. Buckets are placed largest
+ * first, each with the first displacement that sends all of its words to
+ * free, distinct slots; if a bucket finds none, the whole table is retried
+ * with the next seed. The lookup side is in include/irregular_forms.h.
+ */
+
+#include "../include/irregular_forms.h"
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_LINE_LENGTH 256
+#define MAX_FIELD_LENGTH 50 /* MAX_WORD_LENGTH of the program */
+#define MAX_SEED_ATTEMPTS 1000
+#define WORDS_PER_BUCKET 4
+#define FIELD_COUNT (1 + IRREGULAR_FORM_COUNT)
+
+typedef struct {
+  char *word;
+  char *forms[IRREGULAR_FORM_COUNT]; /* NULL for "-" */
+  uint64_t hash;
+  uint32_t bucket;
+} Entry;
+
+typedef struct {
+  uint32_t bucket;
+  uint32_t size;
+} BucketOrder;
+
+/* Parsing */
+
+static bool is_valid_field(const char *field) {
+  size_t len = strlen(field);
+  if (len == 0 || len >= MAX_FIELD_LENGTH) {
+    return false;
+  }
+
+  for (size_t i = 0; i < len; i++) {
+    if (!isalpha((unsigned char)field[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static char *copy_field(const char *field) {
+  char *copy = (char *)malloc(strlen(field) + 1);
+  if (copy != NULL) {
+    strcpy(copy, field);
+  }
+  return copy;
+}
+
+static void free_entries(Entry *entries, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    free(entries[i].word);
+    for (int f = 0; f < IRREGULAR_FORM_COUNT; f++) {
+      free(entries[i].forms[f]);
+    }
+  }
+  free(entries);
+}
+
+/* Parse one data line into entry; false on a malformed line */
+static bool parse_line(char *line, Entry *entry) {
+  char *fields[FIELD_COUNT];
+  int field_count = 0;
+
+  for (char *field = strtok(line, " \t\r\n"); field != NULL;
+       field = strtok(NULL, " \t\r\n")) {
+    if (field_count == FIELD_COUNT) {
+      return false;
+    }
+    fields[field_count++] = field;
+  }
+
+  if (field_count != FIELD_COUNT || !is_valid_field(fields[0])) {
+    return false;
+  }
+
+  for (int f = 1; f < FIELD_COUNT; f++) {
+    if (strcmp(fields[f], "-") != 0 && !is_valid_field(fields[f])) {
+      return false;
+    }
+  }
+
+  memset(entry, 0, sizeof(Entry));
+  entry->word = copy_field(fields[0]);
+  for (int f = 0; f < IRREGULAR_FORM_COUNT; f++) {
+    if (strcmp(fields[f + 1], "-") != 0) {
+      entry->forms[f] = copy_field(fields[f + 1]);
+    }
+  }
+  return true;
+}
+
+static bool has_irregular_form(const Entry *entry) {
+  for (int f = 0; f < IRREGULAR_FORM_COUNT; f++) {
+    if (entry->forms[f] != NULL) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static Entry *read_entries(const char *path, size_t *count) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    fprintf(stderr, "Error: Unable to open %s.\n", path);
+    return NULL;
+  }
+
+  Entry *entries = NULL;
+  size_t capacity = 0;
+  *count = 0;
+
+  char line[MAX_LINE_LENGTH];
+  int line_number = 0;
+  while (fgets(line, sizeof(line), file) != NULL) {
+    line_number++;
+
+    char *start = line;
+    while (isspace((unsigned char)*start)) {
+      start++;
+    }
+    if (*start == '\0' || *start == '#') {
+      continue;
+    }
+
+    if (*count == capacity) {
+      capacity = capacity == 0 ? 64 : capacity * 2;
+      Entry *grown = (Entry *)realloc(entries, capacity * sizeof(Entry));
+      if (grown == NULL) {
+        fprintf(stderr, "Error: Unable to allocate memory for entries.\n");
+        break;
+      }
+      entries = grown;
+    }
+
+    Entry *entry = &entries[*count];
+    if (!parse_line(start, entry)) {
+      fprintf(stderr,
+              "Error: %s:%d: expected a word and %d forms (letters or "
+              "\"-\").\n",
+              path, line_number, IRREGULAR_FORM_COUNT);
+      break;
+    }
+    (*count)++;
+
+    if (entry->word == NULL || !has_irregular_form(entry)) {
+      fprintf(stderr, "Error: %s:%d: entry has no irregular form.\n", path,
+              line_number);
+      break;
+    }
+
+    for (size_t i = 0; i + 1 < *count; i++) {
+      if (strcmp(entries[i].word, entry->word) == 0) {
+        fprintf(stderr, "Error: %s:%d: duplicate word \"%s\".\n", path,
+                line_number, entry->word);
+        fclose(file);
+        free_entries(entries, *count);
+        return NULL;
+      }
+    }
+  }
+
+  bool complete = feof(file) && !ferror(file);
+  fclose(file);
+  if (!complete) {
+    free_entries(entries, *count);
+    return NULL;
+  }
+
+  if (entries == NULL) {
+    /* An empty table is valid; keep a non-NULL result */
+    entries = (Entry *)malloc(sizeof(Entry));
+  }
+  return entries;
+}
+
+/* Placement */
+
+static int compare_bucket_order(const void *a, const void *b) {
+  const BucketOrder *x = (const BucketOrder *)a;
+  const BucketOrder *y = (const BucketOrder *)b;
+  if (x->size != y->size) {
+    return x->size > y->size ? -1 : 1;
+  }
+  return x->bucket < y->bucket ? -1 : x->bucket > y->bucket;
+}
+
+/* Try to place one bucket's members with the given displacement */
+static bool try_displacement(const Entry *entries, const size_t *members,
+                             uint32_t member_count, uint32_t displacement,
+                             uint32_t slot_count, int32_t *slots) {
+  uint32_t placed = 0;
+  for (; placed < member_count; placed++) {
+    size_t e = members[placed];
+    uint32_t slot =
+        irregular_word_slot(entries[e].hash, displacement, slot_count);
+    if (slots[slot] != -1) {
+      break;
+    }
+    slots[slot] = (int32_t)e;
+  }
+
+  if (placed == member_count) {
+    return true;
+  }
+
+  /* Undo the partial placement */
+  for (uint32_t m = 0; m < placed; m++) {
+    size_t e = members[m];
+    slots[irregular_word_slot(entries[e].hash, displacement, slot_count)] = -1;
+  }
+  return false;
+}
+
+static bool place_entries(Entry *entries, size_t count, uint64_t seed,
+                          uint32_t bucket_count, uint32_t slot_count,
+                          uint32_t *displacements, int32_t *slots) {
+  BucketOrder *order =
+      (BucketOrder *)calloc(bucket_count, sizeof(BucketOrder));
+  size_t *starts = (size_t *)calloc(bucket_count + 1, sizeof(size_t));
+  size_t *members = (size_t *)malloc((count > 0 ? count : 1) * sizeof(size_t));
+  if (order == NULL || starts == NULL || members == NULL) {
+    fprintf(stderr, "Error: Unable to allocate memory for placement.\n");
+    free(order);
+    free(starts);
+    free(members);
+    return false;
+  }
+
+  /* Group the entries by bucket */
+  for (size_t i = 0; i < count; i++) {
+    entries[i].hash = hash_irregular_word(entries[i].word, seed);
+    entries[i].bucket = irregular_word_bucket(entries[i].hash, bucket_count);
+    starts[entries[i].bucket + 1]++;
+  }
+  for (uint32_t b = 0; b < bucket_count; b++) {
+    order[b].bucket = b;
+    order[b].size = (uint32_t)starts[b + 1];
+    starts[b + 1] += starts[b];
+  }
+  for (size_t i = 0; i < count; i++) {
+    members[starts[entries[i].bucket]++] = i;
+  }
+
+  /* Filling moved every start to the next bucket's; shift them back */
+  for (uint32_t b = bucket_count; b > 0; b--) {
+    starts[b] = starts[b - 1];
+  }
+  starts[0] = 0;
+
+  qsort(order, bucket_count, sizeof(BucketOrder), compare_bucket_order);
+
+  for (uint32_t s = 0; s < slot_count; s++) {
+    slots[s] = -1;
+  }
+
+  bool placed_all = true;
+  uint32_t offsets = slot_count < 0x10000u ? slot_count : 0x10000u;
+  for (uint32_t o = 0; o < bucket_count && placed_all; o++) {
+    uint32_t b = order[o].bucket;
+    displacements[b] = 0;
+    if (order[o].size == 0) {
+      continue;
+    }
+
+    bool placed = false;
+    for (uint32_t d0 = 0; d0 < offsets && !placed; d0++) {
+      for (uint32_t d1 = 0; d1 < offsets && !placed; d1++) {
+        uint32_t displacement = d0 << 16 | d1;
+        placed = try_displacement(entries, &members[starts[b]], order[o].size,
+                                  displacement, slot_count, slots);
+        if (placed) {
+          displacements[b] = displacement;
+        }
+      }
+    }
+    placed_all = placed;
+  }
+
+  free(order);
+  free(starts);
+  free(members);
+  return placed_all;
+}
+
+/* Output */
+
+static void write_form(FILE *file, const char *form) {
+  if (form == NULL) {
+    fprintf(file, "NULL");
+  } else {
+    fprintf(file, "\"%s\"", form);
+  }
+}
+
+static bool write_header(const char *path, const char *source,
+                         const Entry *entries, size_t count, uint64_t seed,
+                         uint32_t bucket_count, uint32_t slot_count,
+                         const uint32_t *displacements, const int32_t *slots) {
+  FILE *file = fopen(path, "w");
+  if (file == NULL) {
+    fprintf(stderr, "Error: Unable to create %s.\n", path);
+    return false;
+  }
+
+  fprintf(file,
+          "/* Generated by tools/gen_irregular_forms.c from %s; do not "
+          "edit */\n\n",
+          source);
+  fprintf(file, "#ifndef IRREGULAR_FORMS_TABLE_H\n");
+  fprintf(file, "#define IRREGULAR_FORMS_TABLE_H\n\n");
+  fprintf(file, "#include <stddef.h>\n\n");
+  fprintf(file, "#define IRREGULAR_WORD_COUNT %lu\n", (unsigned long)count);
+  fprintf(file, "#define IRREGULAR_WORD_SEED UINT64_C(%llu)\n",
+          (unsigned long long)seed);
+  fprintf(file, "#define IRREGULAR_WORD_BUCKETS %lu\n",
+          (unsigned long)bucket_count);
+  fprintf(file, "#define IRREGULAR_WORD_SLOTS %lu\n\n",
+          (unsigned long)slot_count);
+
+  fprintf(file, "static const uint32_t "
+                "g_irregular_word_displacements[IRREGULAR_WORD_BUCKETS] = {\n");
+  for (uint32_t b = 0; b < bucket_count; b++) {
+    fprintf(file, "    0x%08lXu,\n", (unsigned long)displacements[b]);
+  }
+  fprintf(file, "};\n\n");
+
+  fprintf(file,
+          "static const IrregularWord g_irregular_words[IRREGULAR_WORD_SLOTS] "
+          "= {\n");
+  for (uint32_t s = 0; s < slot_count; s++) {
+    if (slots[s] < 0) {
+      fprintf(file, "    {NULL, {NULL}},\n");
+      continue;
+    }
+
+    const Entry *entry = &entries[slots[s]];
+    fprintf(file, "    {\"%s\", {", entry->word);
+    for (int f = 0; f < IRREGULAR_FORM_COUNT; f++) {
+      fputs(f > 0 ? ", " : "", file);
+      write_form(file, entry->forms[f]);
+    }
+    fprintf(file, "}},\n");
+  }
+  fprintf(file, "};\n\n");
+  fprintf(file, "#endif /* IRREGULAR_FORMS_TABLE_H */\n");
+
+  if (fclose(file) != 0) {
+    fprintf(stderr, "Error: Unable to write %s.\n", path);
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s <data file> <header>\n", argv[0]);
+    return 1;
+  }
+
+  size_t count;
+  Entry *entries = read_entries(argv[1], &count);
+  if (entries == NULL) {
+    return 1;
+  }
+
+  /* Load factor of about 0.8 */
+  size_t slots_needed = count + count / 4 + 1;
+  if (slots_needed > IRREGULAR_WORD_MAX_SLOTS) {
+    fprintf(stderr, "Error: Too many irregular words (%lu).\n",
+            (unsigned long)count);
+    free_entries(entries, count);
+    return 1;
+  }
+  uint32_t slot_count = (uint32_t)slots_needed;
+  uint32_t bucket_count = (uint32_t)(count / WORDS_PER_BUCKET + 1);
+
+  uint32_t *displacements =
+      (uint32_t *)malloc(bucket_count * sizeof(uint32_t));
+  int32_t *slots = (int32_t *)malloc(slot_count * sizeof(int32_t));
+  if (displacements == NULL || slots == NULL) {
+    fprintf(stderr, "Error: Unable to allocate memory for table.\n");
+    free(displacements);
+    free(slots);
+    free_entries(entries, count);
+    return 1;
+  }
+
+  uint64_t seed = 0;
+  bool placed = place_entries(entries, count, seed, bucket_count, slot_count,
+                              displacements, slots);
+  while (!placed && ++seed < MAX_SEED_ATTEMPTS) {
+    placed = place_entries(entries, count, seed, bucket_count, slot_count,
+                           displacements, slots);
+  }
+
+  bool written = false;
+  if (!placed) {
+    fprintf(stderr, "Error: No perfect hash found after %d seeds.\n",
+            MAX_SEED_ATTEMPTS);
+  } else {
+    written = write_header(argv[2], argv[1], entries, count, seed,
+                           bucket_count, slot_count, displacements, slots);
+  }
+
+  free(displacements);
+  free(slots);
+  free_entries(entries, count);
+  return written ? 0 : 1;
+}